@@ -0,0 +1,55 @@
+/* Bare-metal C reference of hanoi_pack_moves in ../q2-hanoi/hanoi.S,
+ * for the optimisation-level matrix: the same per-disk position loop
+ * with 32-bit move indices, and no libgcc calls at any -O level.
+ */
+#include <stdint.h>
+
+#include "hanoi_stream.h"
+
+/* (from << 2 | to) -> pair code */
+static const uint8_t pair_codes[12] = {0, 0, 1, 0, 2, 0, 3, 0, 4, 5, 0, 0};
+
+uint32_t hanoi_pack_moves(uint32_t n, void *buf, uint32_t fmt)
+{
+    uint8_t pos[HANOI_MAX_DISKS + 1];
+    uint8_t *out8 = buf;
+    uint32_t *out32 = buf;
+    uint32_t end = 1u << n;
+    uint32_t step0 = (n & 1) + 1;
+    uint32_t acc = 0, shift = 0;
+
+    for (uint32_t d = 0; d <= HANOI_MAX_DISKS; d++)
+        pos[d] = 0;
+
+    for (uint32_t k = 1; k != end; k++) {
+        uint32_t disk = 0, from, to;
+
+        while (!((k >> disk) & 1))
+            disk++;
+        from = pos[disk];
+        if (disk == 0) {
+            to = from + step0;
+            if (to >= 3)
+                to -= 3;
+        } else {
+            to = 3 - from - pos[0];
+        }
+        pos[disk] = to;
+
+        uint32_t code = pair_codes[from << 2 | to];
+        if (fmt == HANOI_FMT_8BIT) {
+            *out8++ = disk << 3 | code;
+        } else {
+            acc |= code << shift;
+            shift += 3;
+            if (shift == 3 * HANOI_CODES_PER_WORD) {
+                *out32++ = acc;
+                acc = 0;
+                shift = 0;
+            }
+        }
+    }
+    if (shift)
+        *out32 = acc;
+    return end - 1;
+}
@@ -0,0 +1,170 @@
+/* Driver of the optimisation-level matrix (opt_matrix.sh).
+ *
+ * Built once per kernel with -DKERNEL_UF8, -DKERNEL_RSQRT or
+ * -DKERNEL_HANOI, and -DIMPL_ASM to call the hand-written assembly
+ * instead of the C reference. Only the kernel calls are timed; the
+ * results are checked afterwards and reported on one line:
+ *
+ *   matrix: cycles <n> instret <n> value <checksum> PASS|FAIL
+ */
+#include <stdint.h>
+
+#include "runtime.h"
+#include "support.h"
+
+static uint64_t t_cycles, t_instret;
+
+#define TIMED(stmt)                                      \
+    do {                                                 \
+        uint64_t c0 = get_cycles(), i0 = get_instret();  \
+        stmt;                                            \
+        t_instret = get_instret() - i0;                  \
+        t_cycles = get_cycles() - c0;                    \
+    } while (0)
+
+#if defined(KERNEL_UF8)
+
+#ifdef IMPL_ASM
+extern uint32_t uf8_encode_abi(uint32_t value);
+#define ENCODE(v) uf8_encode_abi(v)
+#else
+#include "kernels.h"
+#define ENCODE(v) uf8_encode(v)
+#endif
+
+static uint32_t values[256], codes[256];
+
+/* Encode the decoded value of every uf8 code and check the round trip */
+static int run_kernel(uint32_t *value)
+{
+    uint32_t sum = 0;
+    int ok = 1;
+
+    for (uint32_t i = 0; i < 256; i++)
+        values[i] = ((((i & 15) | 16) << (i >> 4))) - 16;
+    TIMED(for (uint32_t i = 0; i < 256; i++) codes[i] = ENCODE(values[i]));
+    for (uint32_t i = 0; i < 256; i++) {
+        if (codes[i] != i)
+            ok = 0;
+        sum += codes[i];
+    }
+    *value = sum;
+    return ok;
+}
+
+#elif defined(KERNEL_RSQRT)
+
+/* Both builds run kernels.c's fast_rsqrt; IMPL_ASM links clz and mul32
+ * from compute.S (KERNELS_ASM_PRIMITIVES), as the q3 image does.
+ */
+#include "kernels.h"
+
+/* The q3 suite's inputs and expected values (exact for the first 8) */
+#define RSQRT_CASES 15
+#define RSQRT_EXACT 8
+static uint32_t rsqrt_in[RSQRT_CASES] = {
+    0, 1, 0xFFFFFFFF, 4, 16, 1024, 65536, 1048576,
+    100, 2, 10, 42, 12345, 1000000, 2000000000,
+};
+static uint32_t rsqrt_expect[RSQRT_CASES] = {
+    0xFFFFFFFF, 65536, 1, 32768, 16384, 2048, 256, 64,
+    6554, 46341, 20723, 10103, 590, 66, 1,
+};
+static uint32_t rsqrt_out[RSQRT_CASES];
+
+static int run_kernel(uint32_t *value)
+{
+    uint32_t sum = 0;
+    int ok = 1;
+
+    TIMED(for (uint32_t i = 0; i < RSQRT_CASES; i++)
+              rsqrt_out[i] = fast_rsqrt(rsqrt_in[i]));
+    for (uint32_t i = 0; i < RSQRT_CASES; i++) {
+        uint32_t got = rsqrt_out[i], want = rsqrt_expect[i];
+        uint32_t diff = got > want ? got - want : want - got;
+        uint32_t margin, rem;
+
+        /* 10% tolerance, at least 2, as check_approx */
+        margin = support_udiv(want, 10, &rem);
+        if (margin < 2)
+            margin = 2;
+        if (i < RSQRT_EXACT ? diff != 0 : diff > margin)
+            ok = 0;
+        sum += got;
+    }
+    *value = sum;
+    return ok;
+}
+
+#elif defined(KERNEL_HANOI)
+
+#include "hanoi_stream.h"
+
+#define MATRIX_HANOI_DISKS 12
+
+/* hanoi.S (IMPL_ASM) or hanoi_ref.c */
+extern uint32_t hanoi_pack_moves(uint32_t n, void *buf, uint32_t fmt);
+
+static uint32_t stream[HANOI_STREAM_WORDS(MATRIX_HANOI_DISKS, HANOI_FMT_3BIT)];
+
+/* Replays the 3-bit stream: every move is legal and ends on peg C */
+static int replay(uint32_t n, uint32_t moves)
+{
+    uint32_t pegs[3] = {(1u << n) - 1, 0, 0};
+    const uint32_t *p = stream;
+    uint32_t shift = 0;
+
+    for (uint32_t k = 1; k <= moves; k++) {
+        uint32_t code = (*p >> shift) & 7;
+        uint32_t from = HANOI_CODE_FROM(code), to = HANOI_CODE_TO(code);
+        uint32_t bit = k & -k;
+
+        if ((pegs[from] & -pegs[from]) != bit ||
+            (pegs[to] && (pegs[to] & -pegs[to]) < bit))
+            return 0;
+        pegs[from] &= ~bit;
+        pegs[to] |= bit;
+        shift += 3;
+        if (shift == 3 * HANOI_CODES_PER_WORD) {
+            p++;
+            shift = 0;
+        }
+    }
+    return pegs[2] == (1u << n) - 1;
+}
+
+static int run_kernel(uint32_t *value)
+{
+    uint32_t moves = 0, sum = 0;
+
+    TIMED(moves = hanoi_pack_moves(MATRIX_HANOI_DISKS, stream,
+                                   HANOI_FMT_3BIT));
+    for (uint32_t i = 0; i < sizeof(stream) / sizeof(stream[0]); i++)
+        sum ^= stream[i];
+    *value = sum;
+    return moves == HANOI_MOVES(MATRIX_HANOI_DISKS) &&
+           replay(MATRIX_HANOI_DISKS, moves);
+}
+
+#else
+#error "define KERNEL_UF8, KERNEL_RSQRT or KERNEL_HANOI"
+#endif
+
+int main(void)
+{
+    uint32_t value = 0;
+    int ok = run_kernel(&value);
+
+    TEST_LOGGER("matrix: cycles ");
+    print_dec((unsigned long) t_cycles);
+    TEST_LOGGER(" instret ");
+    print_dec((unsigned long) t_instret);
+    TEST_LOGGER(" value ");
+    print_dec(value);
+    if (ok) {
+        TEST_LOGGER(" PASS\n");
+    } else {
+        TEST_LOGGER(" FAIL\n");
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+#!/bin/sh
+# Optimisation-level build matrix: builds every kernel as its C
+# reference and as the hand-written assembly at each -O level, runs it
+# under rv32emu and prints one table of cycles, instret and .text size.
+#
+# Usage: CROSS_COMPILE=riscv-none-elf- EMU=.../rv32emu ./opt_matrix.sh
+#        (or "make matrix"); OPTS overrides the list of levels.
+#
+# Only the kernel objects take the -O level; the driver (matrix_main.c)
+# and runtime (support.c) are built at -O2 in every configuration. A
+# kernel with no C source (uf8 and hanoi asm) is the same image at
+# every level, so it is built and printed once, with opt "-".
+# .text is the sum of the kernel objects, which for the assembly builds
+# includes the rest of the hand-written file (test loop, print helpers).
+# Each build also leaves its disassembly next to the ELF, matrix.S.
+set -e
+
+: "${CROSS_COMPILE:?set CROSS_COMPILE}"
+: "${EMU:?set EMU to the rv32emu binary}"
+OPTS=${OPTS:-"O0 O1 O2 Os Ofast"}
+BUILD=${BUILD:-build}
+
+CC=${CROSS_COMPILE}gcc
+AS=${CROSS_COMPILE}as
+LD=${CROSS_COMPILE}ld
+SIZE=${CROSS_COMPILE}size
+OBJDUMP=${CROSS_COMPILE}objdump
+
+COMMON=../common
+RUNTIME=../q1-uf8
+# -fno-tree-loop-distribute-patterns: see CFLAGS in the Makefile
+CFLAGS="-g -march=rv32i_zicsr -fno-tree-loop-distribute-patterns"
+CFLAGS="$CFLAGS -I$COMMON -I../host -I../q2-hanoi"
+AFLAGS="-g -march=rv32izicsr -I$COMMON"
+
+kernel_srcs() {
+    case "$1-$2" in
+    uf8-c) echo ../host/kernels.c ;;
+    uf8-asm) echo ../q1-uf8/q1-uf8.S ;;
+    rsqrt-c) echo ../host/kernels.c ;;
+    rsqrt-asm) echo ../host/kernels.c ../q3-rsqrt/compute.S ;;
+    hanoi-c) echo hanoi_ref.c ;;
+    hanoi-asm) echo ../q2-hanoi/hanoi.S ;;
+    esac
+}
+
+# Does the kernel have a C source, i.e. does the -O level matter?
+kernel_has_c() {
+    for src in $(kernel_srcs $1 $2); do
+        case "$src" in
+        *.c) return 0 ;;
+        esac
+    done
+    return 1
+}
+
+# compile <src> <obj> <cflags...>
+compile() {
+    src=$1 obj=$2
+    shift 2
+    case "$src" in
+    *.S) $AS $AFLAGS "$src" -o "$obj" ;;
+    *.c) $CC $CFLAGS "$@" -c "$src" -o "$obj" ;;
+    esac
+}
+
+text_size() {
+    $SIZE -A "$1" | awk '$1 == ".text" { print $2 }'
+}
+
+printf "%-6s %-4s %-6s %10s %10s %6s %s\n" \
+    kernel impl opt cycles instret text check
+
+for kernel in uf8 rsqrt hanoi; do
+    KERNEL=$(echo $kernel | tr a-z A-Z)
+    for impl in c asm; do
+        defs="-DKERNEL_$KERNEL"
+        [ $impl = asm ] && defs="$defs -DIMPL_ASM -DKERNELS_ASM_PRIMITIVES"
+        levels=$OPTS
+        kernel_has_c $kernel $impl || levels=none
+        for opt in $levels; do
+            if [ $opt = none ]; then
+                dir=$BUILD/$kernel-$impl label=- kflags=
+            else
+                dir=$BUILD/$kernel-$impl-$opt label=-$opt kflags=-$opt
+            fi
+            mkdir -p "$dir"
+
+            objs=""
+            for src in $RUNTIME/start.S $RUNTIME/perfcounter.S support.c \
+                       $COMMON/prof.c $COMMON/prof_scope.S; do
+                obj=$dir/$(basename "${src%.*}").o
+                compile "$src" "$obj" -O2
+                objs="$objs $obj"
+            done
+            compile matrix_main.c "$dir/matrix_main.o" -O2 $defs
+            objs="$objs $dir/matrix_main.o"
+
+            text=0
+            for src in $(kernel_srcs $kernel $impl); do
+                obj=$dir/k_$(basename "${src%.*}").o
+                compile "$src" "$obj" $kflags $defs
+                text=$((text + $(text_size "$obj")))
+                objs="$objs $obj"
+            done
+
+            $LD -T $RUNTIME/linker.ld -o "$dir/matrix.elf" $objs
+            $OBJDUMP -d "$dir/matrix.elf" >"$dir/matrix.S"
+            line=$("$EMU" "$dir/matrix.elf" | grep '^matrix:' || true)
+            set -- $line
+            if [ $# -lt 8 ]; then
+                printf "%-6s %-4s %-6s %10s %10s %6s %s\n" \
+                    $kernel $impl $label - - $text "no result"
+                continue
+            fi
+            printf "%-6s %-4s %-6s %10s %10s %6s %s\n" \
+                $kernel $impl $label $3 $5 $text $8
+        done
+    done
+done
@@ -0,0 +1,305 @@
+/* Combined benchmark image: every kernel linked once against one copy of
+ * the runtime (start.S, perfcounter.S, support.c), so a full sweep is one
+ * build and one emulator launch.
+ *
+ * The kernels run in the order of suite[], which lives in .data: an entry
+ * whose 'enabled' word is patched to 0 in the ELF is skipped without a
+ * rebuild. SUITE_LIST (make suite SUITE="uf8 hanoi") is the build-time
+ * selection; "all" keeps the table as it is. Each kernel that runs
+ * prints
+ *
+ *   suite: <name> cycles <n> instret <n> value <checksum> PASS|FAIL
+ *
+ * plus a "suite.<name>" record (RECORDS=1) for host/perf_gate, and the
+ * last line sums the kernels that ran. Only the kernel calls are timed,
+ * as in matrix_main.c.
+ */
+#include <stdint.h>
+
+#include "hanoi4.h"
+#include "hanoi_stream.h"
+#include "kernels.h"
+#include "record.h"
+#include "runtime.h"
+#include "support.h"
+
+#ifndef SUITE_LIST
+#define SUITE_LIST "all"
+#endif
+
+#ifndef SUITE_HANOI_DISKS
+#define SUITE_HANOI_DISKS 16
+#endif
+#ifndef SUITE_HANOI4_DISKS
+#define SUITE_HANOI4_DISKS 20
+#endif
+#ifndef SUITE_MOVE_AT_DISKS
+#define SUITE_MOVE_AT_DISKS 12
+#endif
+
+/* q1-uf8.S */
+extern uint32_t uf8_encode_abi(uint32_t value);
+/* hanoi.S */
+extern uint32_t hanoi_pack_moves(uint32_t n, void *buf, uint32_t fmt);
+extern uint32_t hanoi_move_at(uint32_t n, uint32_t k);
+extern uint32_t hanoi_verify(uint32_t n, const void *buf, uint32_t fmt,
+                             uint32_t moves, uint32_t pegs);
+
+static uint64_t t_cycles, t_instret;
+
+#define TIMED(stmt)                                      \
+    do {                                                 \
+        uint64_t c0 = get_cycles(), i0 = get_instret();  \
+        stmt;                                            \
+        t_instret = get_instret() - i0;                  \
+        t_cycles = get_cycles() - c0;                    \
+    } while (0)
+
+/* --- Kernels: run, check afterwards, leave a checksum in *value --- */
+
+static uint32_t uf8_values[256], uf8_codes[256];
+
+/* Encode the decoded value of every uf8 code and check the round trip */
+static int run_uf8(uint32_t *value)
+{
+    uint32_t sum = 0;
+    int ok = 1;
+
+    for (uint32_t i = 0; i < 256; i++)
+        uf8_values[i] = ((((i & 15) | 16) << (i >> 4))) - 16;
+    TIMED(for (uint32_t i = 0; i < 256; i++)
+              uf8_codes[i] = uf8_encode_abi(uf8_values[i]));
+    for (uint32_t i = 0; i < 256; i++) {
+        if (uf8_codes[i] != i)
+            ok = 0;
+        sum += uf8_codes[i];
+    }
+    *value = sum;
+    return ok;
+}
+
+/* compute.S's clz over one value per bit position, plus zero */
+static uint32_t clz_in[33], clz_out[33];
+
+static int run_clz(uint32_t *value)
+{
+    uint32_t sum = 0;
+    int ok = 1;
+
+    clz_in[0] = 0;
+    for (uint32_t i = 1; i <= 32; i++)
+        clz_in[i] = (0x80000000u >> (i - 1)) |
+                    (i < 32 ? 0x5a5a5a5au >> i : 0);
+    TIMED(for (uint32_t i = 0; i <= 32; i++) clz_out[i] = clz(clz_in[i]));
+    for (uint32_t i = 0; i <= 32; i++) {
+        if (clz_out[i] != (i ? i - 1 : 32))
+            ok = 0;
+        sum += clz_out[i];
+    }
+    *value = sum;
+    return ok;
+}
+
+/* kernels.c's fast_rsqrt on compute.S's clz/mul32, the q3 inputs */
+#define RSQRT_CASES 15
+#define RSQRT_EXACT 8
+static const uint32_t rsqrt_in[RSQRT_CASES] = {
+    0, 1, 0xFFFFFFFF, 4, 16, 1024, 65536, 1048576,
+    100, 2, 10, 42, 12345, 1000000, 2000000000,
+};
+static const uint32_t rsqrt_expect[RSQRT_CASES] = {
+    0xFFFFFFFF, 65536, 1, 32768, 16384, 2048, 256, 64,
+    6554, 46341, 20723, 10103, 590, 66, 1,
+};
+static uint32_t rsqrt_out[RSQRT_CASES];
+
+static int run_rsqrt(uint32_t *value)
+{
+    uint32_t sum = 0;
+    int ok = 1;
+
+    TIMED(for (uint32_t i = 0; i < RSQRT_CASES; i++)
+              rsqrt_out[i] = fast_rsqrt(rsqrt_in[i]));
+    for (uint32_t i = 0; i < RSQRT_CASES; i++) {
+        uint32_t got = rsqrt_out[i], want = rsqrt_expect[i];
+        uint32_t diff = got > want ? got - want : want - got;
+        uint32_t margin, rem;
+
+        /* 10% tolerance, at least 2, as check_approx */
+        margin = support_udiv(want, 10, &rem);
+        if (margin < 2)
+            margin = 2;
+        if (i < RSQRT_EXACT ? diff != 0 : diff > margin)
+            ok = 0;
+        sum += got;
+    }
+    *value = sum;
+    return ok;
+}
+
+static uint32_t hanoi_stream[HANOI_STREAM_WORDS(SUITE_HANOI_DISKS,
+                                                HANOI_FMT_3BIT)];
+
+/* hanoi.S: pack the 3-bit stream, check it with hanoi_verify */
+static int run_hanoi(uint32_t *value)
+{
+    uint32_t moves = 0, sum = 0;
+
+    TIMED(moves = hanoi_pack_moves(SUITE_HANOI_DISKS, hanoi_stream,
+                                   HANOI_FMT_3BIT));
+    for (uint32_t i = 0; i < sizeof(hanoi_stream) / 4; i++)
+        sum ^= hanoi_stream[i];
+    *value = sum;
+    return moves == HANOI_MOVES(SUITE_HANOI_DISKS) &&
+           !hanoi_verify(SUITE_HANOI_DISKS, hanoi_stream, HANOI_FMT_3BIT,
+                         moves, 3);
+}
+
+/* Word arrays: hanoi_pack_moves wants an aligned buffer */
+static uint32_t move_at_seq[HANOI_STREAM_WORDS(SUITE_MOVE_AT_DISKS,
+                                               HANOI_FMT_8BIT)];
+static uint32_t move_at_out[HANOI_STREAM_WORDS(SUITE_MOVE_AT_DISKS,
+                                               HANOI_FMT_8BIT)];
+
+/* hanoi.S: every move by index, against the sequential 8-bit stream */
+static int run_move_at(uint32_t *value)
+{
+    uint32_t moves = hanoi_pack_moves(SUITE_MOVE_AT_DISKS, move_at_seq,
+                                      HANOI_FMT_8BIT);
+    const uint8_t *seq = (const uint8_t *) move_at_seq;
+    uint8_t *out = (uint8_t *) move_at_out;
+    uint32_t sum = 0;
+    int ok = moves == HANOI_MOVES(SUITE_MOVE_AT_DISKS);
+
+    TIMED(for (uint32_t k = 1; k <= moves; k++)
+              out[k - 1] = hanoi_move_at(SUITE_MOVE_AT_DISKS, k));
+    for (uint32_t k = 0; k < moves; k++) {
+        if (out[k] != seq[k])
+            ok = 0;
+        sum += out[k];
+    }
+    *value = sum;
+    return ok;
+}
+
+/* Frame-Stewart needs far fewer moves than 2^n - 1: 289 for 20 disks */
+#define SUITE_HANOI4_WORDS 128
+static uint32_t hanoi4_stream[SUITE_HANOI4_WORDS];
+
+/* hanoi4.c: Frame-Stewart four-peg stream, checked with hanoi_verify */
+static int run_hanoi4(uint32_t *value)
+{
+    uint32_t moves = 0, sum = 0;
+
+    if (hanoi4_moves(SUITE_HANOI4_DISKS) >
+        SUITE_HANOI4_WORDS * HANOI4_CODES_PER_WORD)
+        return 0;
+    TIMED(moves = hanoi4_pack_moves(SUITE_HANOI4_DISKS, hanoi4_stream,
+                                    HANOI_FMT_4BIT));
+    for (uint32_t i = 0; i < SUITE_HANOI4_WORDS; i++)
+        sum ^= hanoi4_stream[i];
+    *value = sum;
+    return moves == hanoi4_moves(SUITE_HANOI4_DISKS) &&
+           !hanoi_verify(SUITE_HANOI4_DISKS, hanoi4_stream, HANOI_FMT_4BIT,
+                         moves, 4);
+}
+
+/* --- Selection table --- */
+
+struct suite_kernel {
+    const char *name;
+    const char *record_id;
+    int (*run)(uint32_t *value);
+    uint32_t enabled;
+};
+
+/* Not const: stays in .data so 'enabled' can be patched in the ELF */
+struct suite_kernel suite[] = {
+    {"uf8", "suite.uf8", run_uf8, 1},
+    {"clz", "suite.clz", run_clz, 1},
+    {"rsqrt", "suite.rsqrt", run_rsqrt, 1},
+    {"hanoi", "suite.hanoi", run_hanoi, 1},
+    {"move_at", "suite.move_at", run_move_at, 1},
+    {"hanoi4", "suite.hanoi4", run_hanoi4, 1},
+};
+#define SUITE_KERNELS (sizeof(suite) / sizeof(suite[0]))
+
+static uint32_t str_len(const char *s)
+{
+    uint32_t len = 0;
+
+    while (s[len] != '\0')
+        len++;
+    return len;
+}
+
+/* Is name one of the space-separated words of list? */
+static int in_list(const char *list, const char *name)
+{
+    while (*list) {
+        uint32_t i = 0;
+
+        while (*list == ' ')
+            list++;
+        while (name[i] != '\0' && list[i] == name[i])
+            i++;
+        if (name[i] == '\0' && (list[i] == ' ' || list[i] == '\0'))
+            return 1;
+        while (*list && *list != ' ')
+            list++;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    static const char list[] = SUITE_LIST;
+    uint64_t total_cycles = 0, total_instret = 0;
+    uint32_t ran = 0, failed = 0;
+    int all = in_list(list, "all");
+
+    TEST_LOGGER("\n=== Kernel suite ===\n\n");
+    for (uint32_t i = 0; i < SUITE_KERNELS; i++) {
+        struct suite_kernel *k = &suite[i];
+        uint32_t value = 0;
+
+        if (!k->enabled || (!all && !in_list(list, k->name)))
+            continue;
+
+        /* A kernel that fails before TIMED must not report the last one's */
+        t_cycles = t_instret = 0;
+        int ok = k->run(&value);
+        RECORD(k->record_id, ok, (uint32_t) t_cycles, (uint32_t) t_instret,
+               value);
+
+        TEST_LOGGER("suite: ");
+        TEST_OUTPUT(k->name, str_len(k->name));
+        TEST_LOGGER(" cycles ");
+        print_dec((unsigned long) t_cycles);
+        TEST_LOGGER(" instret ");
+        print_dec((unsigned long) t_instret);
+        TEST_LOGGER(" value ");
+        print_dec(value);
+        if (ok) {
+            TEST_LOGGER(" PASS\n");
+        } else {
+            TEST_LOGGER(" FAIL\n");
+            failed++;
+        }
+
+        total_cycles += t_cycles;
+        total_instret += t_instret;
+        ran++;
+    }
+
+    TEST_LOGGER("suite: total cycles ");
+    print_dec((unsigned long) total_cycles);
+    TEST_LOGGER(" instret ");
+    print_dec((unsigned long) total_instret);
+    TEST_LOGGER(" kernels ");
+    print_dec(ran);
+    TEST_LOGGER(" failed ");
+    print_dec(failed);
+    TEST_LOGGER("\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+/* Freestanding support for the bench/ images, see support.h */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "runtime.h"
+#include "support.h"
+
+uint32_t support_udiv(uint32_t n, uint32_t d, uint32_t *rem)
+{
+    uint32_t q = 0, r = 0;
+
+    for (int i = 31; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= d) {
+            r -= d;
+            q |= 1u << i;
+        }
+    }
+    *rem = r;
+    return q;
+}
+
+void print_dec(unsigned long val)
+{
+    char buf[20];
+    char *p = buf + sizeof(buf);
+    uint32_t digit;
+
+    do {
+        val = support_udiv(val, 10, &digit);
+        *--p = '0' + digit;
+    } while (val);
+    printstr(p, (buf + sizeof(buf) - p));
+}
+
+uint32_t __mulsi3(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+
+    while (b) {
+        if (b & 1)
+            r += a;
+        a <<= 1;
+        b >>= 1;
+    }
+    return r;
+}
+
+typedef union {
+    uint64_t u64;
+    struct {
+        uint32_t lo;
+        uint32_t hi;
+    } s;
+} val64;
+
+uint64_t __lshrdi3(uint64_t u, int b)
+{
+    val64 v;
+
+    v.u64 = u;
+    if (b == 0)
+        return u;
+    if (b >= 32) {
+        v.s.lo = v.s.hi >> (b - 32);
+        v.s.hi = 0;
+    } else {
+        v.s.lo = (v.s.lo >> b) | (v.s.hi << (32 - b));
+        v.s.hi >>= b;
+    }
+    return v.u64;
+}
+
+uint64_t __ashldi3(uint64_t u, int b)
+{
+    val64 v;
+
+    v.u64 = u;
+    if (b == 0)
+        return u;
+    if (b >= 32) {
+        v.s.hi = v.s.lo << (b - 32);
+        v.s.lo = 0;
+    } else {
+        v.s.hi = (v.s.hi << b) | (v.s.lo >> (32 - b));
+        v.s.lo <<= b;
+    }
+    return v.u64;
+}
+
+void *memcpy(void *dest, const void *src, size_t n)
+{
+    uint8_t *d = dest;
+    const uint8_t *s = src;
+
+    while (n--)
+        *d++ = *s++;
+    return dest;
+}
+
+void *memset(void *dest, int c, size_t n)
+{
+    uint8_t *d = dest;
+
+    while (n--)
+        *d++ = c;
+    return dest;
+}
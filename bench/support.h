@@ -0,0 +1,14 @@
+#ifndef SUPPORT_H
+#define SUPPORT_H
+
+/* Runtime shared by the bench/ images (matrix_main.c, suite_main.c):
+ * print_dec for runtime.h, and the libgcc/libc entry points the C
+ * references need at any -O level (__mulsi3, 64-bit shifts, memcpy,
+ * memset). Built at -O2 in every configuration.
+ */
+#include <stdint.h>
+
+/* Shift-subtract division, no M extension: returns n / d, *rem = n % d */
+uint32_t support_udiv(uint32_t n, uint32_t d, uint32_t *rem);
+
+#endif /* SUPPORT_H */
@@ -0,0 +1,108 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/* Arena (bump) allocator over the linker-defined heap.
+ *
+ * linker.ld reserves [__heap_start, __heap_end) after .bss; its size
+ * is __heap_size, 1 MiB unless overridden with --defsym. Allocation
+ * moves 'top' up and never frees single blocks: arena_mark/arena_reset
+ * release everything allocated after a mark at once. 'high' keeps the
+ * largest 'top' seen, so arena_report shows how much heap a run needed.
+ *
+ * A pool carves equal-sized objects out of the arena once and recycles
+ * them through a free list.
+ *
+ * Allocations fail by returning NULL; nothing is printed.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+/* Default alignment of arena_alloc */
+#define ARENA_ALIGN 4
+
+struct arena {
+    uintptr_t base, top, end;
+    uintptr_t high; /* high-water mark of top */
+};
+
+typedef uintptr_t arena_mark_t;
+
+struct pool {
+    void *free;        /* singly linked through the first word */
+    uint32_t obj_size; /* rounded up to ARENA_ALIGN */
+    uint32_t count, used, max_used;
+};
+
+/* The whole linker heap, or a caller-provided region */
+void arena_init_heap(struct arena *a);
+void arena_init(struct arena *a, void *base, uint32_t size);
+
+/* align must be a power of two */
+void *arena_alloc_aligned(struct arena *a, uint32_t size, uint32_t align);
+
+static inline void *arena_alloc(struct arena *a, uint32_t size)
+{
+    uintptr_t p = (a->top + ARENA_ALIGN - 1) & ~(uintptr_t) (ARENA_ALIGN - 1);
+
+    if (p < a->top || p > a->end || size > a->end - p)
+        return NULL;
+    a->top = p + size;
+    if (a->top > a->high)
+        a->high = a->top;
+    return (void *) p;
+}
+
+static inline arena_mark_t arena_mark(const struct arena *a)
+{
+    return a->top;
+}
+
+static inline void arena_reset(struct arena *a, arena_mark_t mark)
+{
+    a->top = mark;
+}
+
+static inline uint32_t arena_used(const struct arena *a)
+{
+    return a->top - a->base;
+}
+
+static inline uint32_t arena_high_water(const struct arena *a)
+{
+    return a->high - a->base;
+}
+
+/* Prints "  [heap] used: ... high-water: ... of ... bytes" */
+void arena_report(const struct arena *a);
+
+/* Start-up check of the allocator on a's free space: an aligned
+ * allocation, an allocation past the end, and a pool alloc/free/alloc
+ * round trip. Everything is released again. Prints a "[heap]" line,
+ * emits a record_id record and returns 1 if all held.
+ */
+int arena_check(struct arena *a, const char *record_id);
+
+/* count objects of obj_size bytes; returns 0 if the arena is too small */
+int pool_init(struct pool *p, struct arena *a, uint32_t obj_size,
+              uint32_t count);
+
+static inline void *pool_alloc(struct pool *p)
+{
+    void **obj = p->free;
+
+    if (!obj)
+        return NULL;
+    p->free = *obj;
+    if (++p->used > p->max_used)
+        p->max_used = p->used;
+    return obj;
+}
+
+static inline void pool_free(struct pool *p, void *obj)
+{
+    *(void **) obj = p->free;
+    p->free = obj;
+    p->used--;
+}
+
+#endif /* ARENA_H */
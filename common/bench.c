@@ -0,0 +1,155 @@
+/* Repeated-measurement benchmark runner, see bench.h */
+#include "bench.h"
+#include "record.h"
+#include "runtime.h"
+
+static inline uint32_t read_cycle(void)
+{
+    uint32_t c;
+    asm volatile("csrr %0, cycle" : "=r"(c));
+    return c;
+}
+
+/* Out of line, so bench_call_nop really makes the call */
+__attribute__((noinline)) uint32_t bench_nop(uint32_t a, uint32_t b)
+{
+    (void) b;
+    return a;
+}
+
+uint32_t bench_call_nop(uint32_t a, uint32_t b)
+{
+    return bench_nop(a, b);
+}
+
+/* Software division for RV32I (no M extension) */
+static uint32_t bench_udiv(uint32_t n, uint32_t d)
+{
+    uint32_t q = 0, r = 0;
+
+    for (int i = 31; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= d) {
+            r -= d;
+            q |= 1u << i;
+        }
+    }
+    return q;
+}
+
+static void sort_samples(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t x = v[i], j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+/* Fills samples[] with the cycles of 'batch' calls each, after warm-up */
+static void take_samples(uint32_t *samples, bench_fn fn,
+                         const struct bench_arg *args, uint32_t nargs,
+                         uint32_t batch)
+{
+    uint32_t next = 0;
+
+    for (uint32_t s = 0; s < BENCH_WARMUP + BENCH_SAMPLES; s++) {
+        const struct bench_arg *arg = &args[next];
+        uint32_t t0 = read_cycle();
+        for (uint32_t k = 0; k < batch; k++)
+            fn(arg->a, arg->b);
+        uint32_t t1 = read_cycle();
+
+        if (s >= BENCH_WARMUP)
+            samples[s - BENCH_WARMUP] = t1 - t0;
+        if (++next == nargs)
+            next = 0;
+    }
+    sort_samples(samples, BENCH_SAMPLES);
+}
+
+uint32_t bench_empty_cycles(void)
+{
+    uint32_t samples[BENCH_SAMPLES];
+
+    for (uint32_t s = 0; s < BENCH_SAMPLES; s++) {
+        uint32_t t0 = read_cycle();
+        uint32_t t1 = read_cycle();
+        samples[s] = t1 - t0;
+    }
+    sort_samples(samples, BENCH_SAMPLES);
+    return samples[BENCH_SAMPLES / 2];
+}
+
+struct bench_result bench_run(const char *name, bench_fn fn,
+                              const struct bench_arg *args, uint32_t nargs,
+                              uint32_t batch)
+{
+    return bench_run_base(name, fn, bench_call_nop, args, nargs, batch);
+}
+
+struct bench_result bench_run_base(const char *name, bench_fn fn,
+                                   bench_fn base_fn,
+                                   const struct bench_arg *args,
+                                   uint32_t nargs, uint32_t batch)
+{
+    uint32_t base[BENCH_SAMPLES], samples[BENCH_SAMPLES];
+    struct bench_result r;
+    uint32_t len = 0;
+
+    take_samples(base, base_fn, args, nargs, batch);
+    take_samples(samples, fn, args, nargs, batch);
+
+    uint32_t baseline = base[BENCH_SAMPLES / 2];
+    uint32_t min = samples[0] > baseline ? samples[0] - baseline : 0;
+    uint32_t med = samples[BENCH_SAMPLES / 2] > baseline
+                       ? samples[BENCH_SAMPLES / 2] - baseline
+                       : 0;
+    r.min = bench_udiv(min, batch);
+    r.median = bench_udiv(med, batch);
+    r.empty = bench_empty_cycles();
+
+    while (name[len] != '\0')
+        len++;
+    TEST_LOGGER("  [bench] ");
+    TEST_OUTPUT(name, len);
+    TEST_LOGGER("  batch: ");
+    print_dec(batch);
+    TEST_LOGGER("  min: ");
+    print_dec(r.min);
+    TEST_LOGGER("  median: ");
+    print_dec(r.median);
+    TEST_LOGGER("  cycles/call (empty measurement: ");
+    print_dec(r.empty);
+    TEST_LOGGER(", baseline: ");
+    print_dec(baseline);
+    TEST_LOGGER(")\n");
+
+#ifdef RECORDS
+    /* id "<BENCH_PREFIX>bench.<name>.<batch>": median as cycles, min
+     * as value
+     */
+    char id[RECORD_ID_LEN], digits[10];
+    uint32_t n = 0, nd = 0, b = batch;
+
+    for (const char *s = BENCH_PREFIX "bench."; *s != '\0'; s++)
+        id[n++] = *s;
+    for (uint32_t i = 0; i < len && n < RECORD_ID_LEN - 12; i++)
+        id[n++] = name[i];
+    id[n++] = '.';
+    do {
+        uint32_t q = bench_udiv(b, 10);
+        digits[nd++] = '0' + (b - (q << 3) - (q << 1));
+        b = q;
+    } while (b);
+    while (nd)
+        id[n++] = digits[--nd];
+    id[n] = '\0';
+    RECORD(id, 1, r.median, 0, r.min);
+#endif
+
+    return r;
+}
@@ -0,0 +1,79 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Repeated-measurement benchmark runner.
+ *
+ * A sample reads the cycle CSR directly (no get_cycles call or hi/lo
+ * retry), calls the kernel 'batch' times and reads it again. Each run
+ * first times the same loop around a baseline and subtracts its median:
+ * by default bench_call_nop, a trampoline to the empty bench_nop, which
+ * removes the measurement, loop, trampoline and call overhead. Batches
+ * of K calls per sample resolve kernels shorter than the measurement
+ * noise. After BENCH_WARMUP discarded samples, BENCH_SAMPLES samples are
+ * kept and the min and median net cycles per call are reported.
+ *
+ * Kernels are called through bench_fn. Any other signature goes through
+ * a typed trampoline of that shape, so the kernel is called with its own
+ * prototype:
+ *
+ *     BENCH_TRAMPOLINE(bench_mul32, mul32(a, b))
+ *     bench_run("mul32", bench_mul32, args, BENCH_NARGS(args), 8);
+ *
+ * bench_run_base takes the baseline explicitly, e.g. a trampoline to an
+ * empty copy of an assembly wrapper, so the wrapper's own prologue and
+ * epilogue are subtracted as well.
+ */
+#include <stdint.h>
+
+#define BENCH_SAMPLES 31
+#define BENCH_WARMUP 4
+
+/* Image prefix of the record ids, e.g. "q1." from the Makefile */
+#ifndef BENCH_PREFIX
+#define BENCH_PREFIX ""
+#endif
+
+typedef uint32_t (*bench_fn)(uint32_t a, uint32_t b);
+
+/* static bench_fn 'name' returning 'call', which may use a and b */
+#define BENCH_TRAMPOLINE(name, call)               \
+    static uint32_t name(uint32_t a, uint32_t b)   \
+    {                                              \
+        (void) a;                                  \
+        (void) b;                                  \
+        return (uint32_t) (call);                  \
+    }
+
+struct bench_arg {
+    uint32_t a, b;
+};
+
+#define BENCH_NARGS(args) (sizeof(args) / sizeof((args)[0]))
+
+struct bench_result {
+    uint32_t min;    /* net cycles per call */
+    uint32_t median; /* net cycles per call */
+    uint32_t empty;  /* median cycles of an empty measurement */
+};
+
+uint32_t bench_nop(uint32_t a, uint32_t b);
+/* The default baseline: calls bench_nop as a trampoline calls a kernel */
+uint32_t bench_call_nop(uint32_t a, uint32_t b);
+
+/* Median cycles between two back-to-back counter reads */
+uint32_t bench_empty_cycles(void);
+
+/* Runs fn over args (cycled), 'batch' calls per sample, and prints a
+ * "[bench]" line. Returns the result for callers that want the numbers.
+ */
+struct bench_result bench_run(const char *name, bench_fn fn,
+                              const struct bench_arg *args, uint32_t nargs,
+                              uint32_t batch);
+
+/* bench_run with base_fn timed as the baseline instead of bench_call_nop */
+struct bench_result bench_run_base(const char *name, bench_fn fn,
+                                   bench_fn base_fn,
+                                   const struct bench_arg *args,
+                                   uint32_t nargs, uint32_t batch);
+
+#endif /* BENCH_H */
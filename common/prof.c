@@ -0,0 +1,200 @@
+/* Named-scope profiling: names and the exit report, see prof.h */
+#include "prof.h"
+#include "runtime.h"
+
+/* Mirrors the slot layout documented in prof_scope.S */
+struct prof_slot {
+    uint32_t count;
+    uint32_t start_cycles;
+    uint32_t start_instret;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t sum_cycles[2];  /* lo, hi */
+    uint32_t sum_instret[2]; /* lo, hi */
+    char name[PROF_NAME_LEN];
+    uint32_t from_asm;
+    uint32_t pad[2];
+};
+
+extern struct prof_slot prof_table[PROF_MAX_SCOPES];
+
+/* Empty scopes timed per calibration, the cheapest one is kept */
+#define PROF_CAL_RUNS 8
+
+/* Cost of an empty scope */
+struct prof_cost {
+    uint32_t cycles;
+    uint32_t instret;
+};
+
+/* Copied into the slot, so a scope is one self-contained 64-byte record */
+void prof_name(uint32_t id, const char *name)
+{
+    char *d = prof_table[id].name;
+    uint32_t i = 0;
+
+    while (name[i] != '\0' && i < PROF_NAME_LEN - 1) {
+        d[i] = name[i];
+        i++;
+    }
+    d[i] = '\0';
+}
+
+static void prof_clear(struct prof_slot *s)
+{
+    s->count = 0;
+    s->sum_cycles[0] = s->sum_cycles[1] = 0;
+    s->sum_instret[0] = s->sum_instret[1] = 0;
+}
+
+void prof_reset(void)
+{
+    for (uint32_t id = 0; id < PROF_MAX_SCOPES; id++)
+        prof_clear(&prof_table[id]);
+}
+
+/* 64-bit division without libgcc: constant shifts only */
+static uint64_t prof_div64(uint64_t n, uint64_t d)
+{
+    uint64_t q = 0, r = 0;
+
+    if (d == 0)
+        return 0;
+    for (int i = 0; i < 64; i++) {
+        r = (r << 1) | (n >> 63);
+        n <<= 1;
+        q <<= 1;
+        if (r >= d) {
+            r -= d;
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+/* n * m without __muldi3: shift and add */
+static uint64_t prof_mul64(uint64_t n, uint32_t m)
+{
+    uint64_t p = 0;
+
+    while (m) {
+        if (m & 1)
+            p += n;
+        n <<= 1;
+        m >>= 1;
+    }
+    return p;
+}
+
+static uint64_t join64(const uint32_t v[2])
+{
+    return ((uint64_t) v[1] << 32) | v[0];
+}
+
+static uint32_t prof_sub(uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : 0;
+}
+
+/* Empty-scope cost left in the calibration slot: fastest run, and the
+ * instruction count, which is the same every run
+ */
+static void prof_cal_read(struct prof_cost *c)
+{
+    struct prof_slot *s = &prof_table[PROF_CAL_SCOPE];
+
+    c->cycles = s->min_cycles;
+    c->instret = (uint32_t) prof_div64(join64(s->sum_instret), s->count);
+}
+
+static void prof_calibrate(struct prof_cost *c_cost, struct prof_cost *asm_cost)
+{
+    struct prof_slot *s = &prof_table[PROF_CAL_SCOPE];
+
+    prof_clear(s);
+    for (uint32_t i = 0; i < PROF_CAL_RUNS; i++) {
+        prof_begin(PROF_CAL_SCOPE);
+        prof_end(PROF_CAL_SCOPE);
+    }
+    prof_cal_read(c_cost);
+
+    prof_clear(s);
+    prof_calibrate_asm(PROF_CAL_RUNS);
+    prof_cal_read(asm_cost);
+    prof_clear(s);
+}
+
+static void prof_print_cost(const struct prof_cost *c)
+{
+    print_dec(c->cycles);
+    TEST_LOGGER(" cycles ");
+    print_dec(c->instret);
+    TEST_LOGGER(" instret");
+}
+
+void prof_report(void)
+{
+    struct prof_cost c_cost, asm_cost;
+    uint32_t used = 0;
+
+    for (uint32_t id = 0; id < PROF_CAL_SCOPE; id++)
+        used |= prof_table[id].count;
+    if (!used)
+        return;
+
+    prof_calibrate(&c_cost, &asm_cost);
+    TEST_LOGGER("  [prof] empty scope (subtracted): C ");
+    prof_print_cost(&c_cost);
+    TEST_LOGGER(", asm ");
+    prof_print_cost(&asm_cost);
+    TEST_LOGGER("\n");
+
+    for (uint32_t id = 0; id < PROF_CAL_SCOPE; id++) {
+        struct prof_slot *s = &prof_table[id];
+        const struct prof_cost *cost = s->from_asm ? &asm_cost : &c_cost;
+        uint32_t len = 0;
+
+        if (!s->count)
+            continue;
+
+        /* Net of the empty-scope cost, per sample */
+        uint64_t cycles = join64(s->sum_cycles);
+        uint64_t instret = join64(s->sum_instret);
+        uint64_t over_cycles = prof_mul64(cost->cycles, s->count);
+        uint64_t over_instret = prof_mul64(cost->instret, s->count);
+        cycles = cycles > over_cycles ? cycles - over_cycles : 0;
+        instret = instret > over_instret ? instret - over_instret : 0;
+        /* CPI in hundredths: cycles * 100 / instret */
+        uint32_t cpi = (uint32_t) prof_div64(
+            (cycles << 6) + (cycles << 5) + (cycles << 2), instret);
+
+        TEST_LOGGER("  [prof] ");
+        while (s->name[len] != '\0')
+            len++;
+        if (len) {
+            TEST_OUTPUT(s->name, len);
+        } else {
+            TEST_LOGGER("scope ");
+            print_dec(id);
+        }
+        TEST_LOGGER("  count: ");
+        print_dec(s->count);
+        TEST_LOGGER("  min: ");
+        print_dec(prof_sub(s->min_cycles, cost->cycles));
+        TEST_LOGGER("  mean: ");
+        print_dec((unsigned long) prof_div64(cycles, s->count));
+        TEST_LOGGER("  max: ");
+        print_dec(prof_sub(s->max_cycles, cost->cycles));
+        uint32_t whole = (uint32_t) prof_div64(cpi, 100);
+        uint32_t frac = cpi - ((whole << 6) + (whole << 5) + (whole << 2));
+        TEST_LOGGER("  CPI: ");
+        print_dec(whole);
+        if (frac < 10) {
+            TEST_LOGGER(".0");
+        } else {
+            TEST_LOGGER(".");
+        }
+        print_dec(frac);
+        TEST_LOGGER("\n");
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef PROF_H
+#define PROF_H
+
+/* Named-scope profiling over the cycle/instret counters.
+ *
+ * Each scope id owns a slot in a static table (PROF_MAX_SCOPES); every
+ * PROF_END adds one sample of cycles and instructions since the matching
+ * PROF_BEGIN. prof_report(), called by start.S after main returns,
+ * prints count, min, mean and max cycles and CPI of every used slot,
+ * net of the cost of an empty scope: it first times empty C and
+ * assembly scopes on the reserved slot PROF_CAL_SCOPE and subtracts the
+ * matching one from every sample (the prof.inc macros also save and
+ * restore registers, so assembly scopes cost more).
+ *
+ *     PROF_NAME(PROF_ENCODE, "uf8_encode");
+ *     PROF_BEGIN(PROF_ENCODE);
+ *     x = uf8_encode(v);
+ *     PROF_END(PROF_ENCODE);
+ *
+ * Assembly uses the PROF_BEGIN/PROF_END macros of prof.inc. Scopes with
+ * different ids may nest or overlap; a scope may not nest in itself.
+ * Everything compiles away unless the image is built with PROF=1 (off
+ * by default). Only prof_report subtracts the empty-scope cost: the
+ * images' own Cycles figures and @R records include it when PROF=1.
+ */
+#include <stdint.h>
+
+#define PROF_MAX_SCOPES 16
+#define PROF_NAME_LEN 16
+#define PROF_CAL_SCOPE (PROF_MAX_SCOPES - 1) /* also in prof.inc */
+
+/* prof_scope.S: touch only a0 and t0-t3 so assembly can wrap call sites */
+extern void prof_begin(uint32_t id);
+extern void prof_end(uint32_t id);
+/* prof_scope.S: 'runs' empty prof.inc scopes on PROF_CAL_SCOPE */
+extern void prof_calibrate_asm(uint32_t runs);
+
+void prof_name(uint32_t id, const char *name);
+void prof_reset(void);
+void prof_report(void);
+
+#ifdef PROF
+#define PROF_NAME(id, name) prof_name((id), (name))
+#define PROF_BEGIN(id) prof_begin(id)
+#define PROF_END(id) prof_end(id)
+#else
+#define PROF_NAME(id, name) ((void) 0)
+#define PROF_BEGIN(id) ((void) 0)
+#define PROF_END(id) ((void) 0)
+#endif
+
+#endif /* PROF_H */
@@ -0,0 +1,88 @@
+/* Property-test helpers, see prop.h */
+#include "prop.h"
+#include "record.h"
+#include "runtime.h"
+
+void prop_hist_reset(struct prop_hist *h)
+{
+    h->count = h->max = 0;
+    h->min = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < PROP_HIST_BUCKETS; i++)
+        h->bucket[i] = 0;
+}
+
+void prop_hist_add(struct prop_hist *h, uint32_t cycles)
+{
+    uint32_t b = 0;
+
+    while (b < PROP_HIST_BUCKETS - 1 && (cycles >> (b + 1)))
+        b++;
+    h->bucket[b]++;
+    h->count++;
+    if (cycles < h->min)
+        h->min = cycles;
+    if (cycles > h->max)
+        h->max = cycles;
+}
+
+static void print_name(const char *name)
+{
+    uint32_t len = 0;
+
+    while (name[len] != '\0')
+        len++;
+    TEST_OUTPUT(name, len);
+}
+
+void prop_hist_report(const char *name, const struct prop_hist *h)
+{
+    TEST_LOGGER("  [hist] ");
+    print_name(name);
+    TEST_LOGGER("  calls: ");
+    print_dec(h->count);
+    TEST_LOGGER("  min: ");
+    print_dec(h->count ? h->min : 0);
+    TEST_LOGGER("  max: ");
+    print_dec(h->max);
+    TEST_LOGGER(" cycles\n");
+
+    for (uint32_t b = 0; b < PROP_HIST_BUCKETS; b++) {
+        if (!h->bucket[b])
+            continue;
+        TEST_LOGGER("    [");
+        print_dec(b ? 1u << b : 0);
+        if (b == PROP_HIST_BUCKETS - 1) {
+            TEST_LOGGER(", ...): ");
+        } else {
+            TEST_LOGGER(", ");
+            print_dec(1u << (b + 1));
+            TEST_LOGGER("): ");
+        }
+        print_dec(h->bucket[b]);
+        TEST_LOGGER("\n");
+    }
+}
+
+int prop_result(const char *name, const char *record_id, uint32_t cases,
+                uint32_t failures, uint32_t first_bad)
+{
+    TEST_LOGGER("  [prop] ");
+    print_name(name);
+    if (!failures) {
+        TEST_LOGGER(": PASSED (");
+    } else {
+        TEST_LOGGER(": FAILED ");
+        print_dec(failures);
+        TEST_LOGGER(" of ");
+    }
+    print_dec(cases);
+    TEST_LOGGER(" cases, seed ");
+    print_dec(PROP_SEED);
+    if (failures) {
+        TEST_LOGGER(", first at input ");
+        print_dec(first_bad);
+    }
+    TEST_LOGGER(")\n");
+    RECORD(record_id, !failures, 0, 0, failures);
+    return !failures;
+}
@@ -0,0 +1,62 @@
+#ifndef PROP_H
+#define PROP_H
+
+/* Seeded property tests: a xorshift32 input stream, a pass/fail line
+ * per property and a log2 cycle histogram per kernel.
+ *
+ * The same PROP_SEED gives the same inputs on every run; rebuild with
+ * -DPROP_SEED=n to explore others. Each suite runs PROP_ITERS cases per
+ * property when built with PROPTEST=1 (the default in the Makefiles).
+ */
+#include <stdint.h>
+
+#ifndef PROP_SEED
+#define PROP_SEED 0x2545f491
+#endif
+#ifndef PROP_ITERS
+#define PROP_ITERS 4096
+#endif
+
+/* Bucket i counts calls of [2^i, 2^(i+1)) cycles; the last is open */
+#define PROP_HIST_BUCKETS 16
+
+struct prop_hist {
+    uint32_t count, min, max;
+    uint32_t bucket[PROP_HIST_BUCKETS];
+};
+
+static inline uint32_t prop_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/* Random value with a random magnitude, so small inputs are common */
+static inline uint32_t prop_rand_mag(uint32_t *state)
+{
+    uint32_t r = prop_rand(state);
+    return r >> (prop_rand(state) & 31);
+}
+
+/* Low word of the cycle CSR, without get_cycles' call and retry loop */
+static inline uint32_t prop_cycles(void)
+{
+    uint32_t c;
+    asm volatile("csrr %0, cycle" : "=r"(c));
+    return c;
+}
+
+void prop_hist_reset(struct prop_hist *h);
+void prop_hist_add(struct prop_hist *h, uint32_t cycles);
+void prop_hist_report(const char *name, const struct prop_hist *h);
+
+/* Prints "  [prop] <name>: PASSED|FAILED ..." and emits a record under
+ * record_id (dotted, e.g. "q1.prop.uf8_roundtrip"); returns failures == 0
+ */
+int prop_result(const char *name, const char *record_id, uint32_t cases,
+                uint32_t failures, uint32_t first_bad);
+
+#endif /* PROP_H */
@@ -0,0 +1,41 @@
+/* Tagged result records, see record.h */
+#include "record.h"
+#include "runtime.h"
+
+char *record_put_hex(char *p, uint32_t v)
+{
+    int shift = 28;
+
+    while (shift > 0 && !(v >> shift))
+        shift -= 4;
+    for (; shift >= 0; shift -= 4) {
+        uint32_t d = (v >> shift) & 0xf;
+        *p++ = d < 10 ? '0' + d : 'a' + d - 10;
+    }
+    return p;
+}
+
+void record_emit(const char *id, int pass, uint32_t cycles, uint32_t instret,
+                 uint32_t value)
+{
+    /* "@R " + id + " P" + three " %x" fields + '\n' */
+    char line[3 + RECORD_ID_LEN + 2 + 3 * 9 + 1];
+    char *p = line;
+
+    *p++ = '@';
+    *p++ = 'R';
+    *p++ = ' ';
+    /* Copied into the line so the record goes out in one ecall */
+    for (uint32_t i = 0; id[i] != '\0' && i < RECORD_ID_LEN; i++)
+        *p++ = id[i] == ' ' ? '_' : id[i];
+    *p++ = ' ';
+    *p++ = pass ? 'P' : 'F';
+    *p++ = ' ';
+    p = record_put_hex(p, cycles);
+    *p++ = ' ';
+    p = record_put_hex(p, instret);
+    *p++ = ' ';
+    p = record_put_hex(p, value);
+    *p++ = '\n';
+    TEST_OUTPUT(line, p - line);
+}
@@ -0,0 +1,36 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+/* Machine-readable result records, one line per test:
+ *
+ *   @R <id> <P|F> <cycles> <instret> <value>
+ *
+ * Numbers are lowercase hex without a prefix, produced with shifts
+ * only (no print_dec), and the whole line goes out in one ecall. An
+ * instret of 0 means only cycles were measured. host/perf_gate parses
+ * these lines and ignores everything else in the log.
+ *
+ * RECORD() compiles to nothing unless the image is built with
+ * -DRECORDS (make RECORDS=1).
+ */
+#include <stdint.h>
+
+/* Longer ids are truncated */
+#define RECORD_ID_LEN 32
+
+void record_emit(const char *id, int pass, uint32_t cycles, uint32_t instret,
+                 uint32_t value);
+
+/* Append v in the record number format, return the new end */
+char *record_put_hex(char *p, uint32_t v);
+
+#ifdef RECORDS
+#define RECORD(id, pass, cycles, instret, value) \
+    record_emit(id, pass, cycles, instret, value)
+#else
+#define RECORD(id, pass, cycles, instret, value) \
+    do {                                         \
+    } while (0)
+#endif
+
+#endif /* RECORD_H */
@@ -0,0 +1,34 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+/* Bare-metal helpers shared by the common/ modules. Each test image's
+ * main.c provides print_dec; perfcounter.S provides the counters.
+ */
+#include <stdint.h>
+
+#define printstr(ptr, length)                   \
+    do {                                        \
+        asm volatile(                           \
+            "add a7, x0, 0x40;"                 \
+            "add a0, x0, 0x1;" /* stdout */     \
+            "add a1, x0, %0;"                   \
+            "mv a2, %1;" /* length character */ \
+            "ecall;"                            \
+            :                                   \
+            : "r"(ptr), "r"(length)             \
+            : "a0", "a1", "a2", "a7", "memory");          \
+    } while (0)
+
+#define TEST_OUTPUT(msg, length) printstr(msg, length)
+
+#define TEST_LOGGER(msg)                     \
+    {                                        \
+        static const char _msg[] = msg;      \
+        TEST_OUTPUT(_msg, sizeof(_msg) - 1); \
+    }
+
+extern uint64_t get_cycles(void);
+extern uint64_t get_instret(void);
+extern void print_dec(unsigned long val);
+
+#endif /* RUNTIME_H */
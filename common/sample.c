@@ -0,0 +1,60 @@
+/* PC-sampling histogram dump, see sample.h */
+#include "record.h"
+#include "runtime.h"
+#include "sample.h"
+
+extern const uint32_t sample_nbuckets, sample_shift;
+extern uint32_t sample_hist[], sample_other, sample_stop_cause;
+extern char __text_start[], __text_end[];
+
+static void sample_line(const char *tag, uint32_t a, uint32_t b)
+{
+    /* "@S " + tag or address + ' ' + count + '\n' */
+    char line[3 + 9 + 9 + 1];
+    char *p = line;
+
+    *p++ = '@';
+    *p++ = 'S';
+    *p++ = ' ';
+    if (tag) {
+        while (*tag)
+            *p++ = *tag++;
+    } else {
+        p = record_put_hex(p, a);
+    }
+    *p++ = ' ';
+    p = record_put_hex(p, b);
+    *p++ = '\n';
+    TEST_OUTPUT(line, p - line);
+}
+
+void sample_report(void)
+{
+    uint32_t base = (uint32_t) (uintptr_t) __text_start;
+    uint32_t text = (uint32_t) (uintptr_t) __text_end - base;
+    uint32_t covered = sample_nbuckets << sample_shift;
+
+    /* PCs past the covered range only show up in "other" */
+    if (text > covered) {
+        TEST_LOGGER("  [sample] .text is ");
+        print_dec(text);
+        TEST_LOGGER(" bytes, the histogram covers ");
+        print_dec(covered);
+        TEST_LOGGER("; raise SAMPLE_SHIFT\n");
+    }
+
+    uint32_t total = sample_other;
+
+    for (uint32_t i = 0; i < sample_nbuckets; i++) {
+        if (sample_hist[i])
+            sample_line(0, base + (i << sample_shift), sample_hist[i]);
+        total += sample_hist[i];
+    }
+    /* An emulator without the CLINT timer runs the image unsampled */
+    if (!total && !sample_stop_cause)
+        TEST_LOGGER("  [sample] no timer interrupt arrived, no CLINT at "
+                    "SAMPLE_MTIME/SAMPLE_MTIMECMP?\n");
+    sample_line("other", 0, sample_other);
+    if (sample_stop_cause)
+        sample_line("stop", 0, sample_stop_cause);
+}
@@ -0,0 +1,31 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+/* Statistical PC profiler for the bare-metal images.
+ *
+ * With SAMPLE=1, start.S calls sample_start() before main and
+ * sample_stop() plus sample_report() after it. The machine timer then
+ * interrupts every SAMPLE_PERIOD ticks and sample_trap.S counts the
+ * interrupted PC in a histogram over .text. sample_report() prints
+ * one line per non-empty slot,
+ *
+ *   @S <pc> <samples>
+ *
+ * in the hex format of record.h, followed by "@S other <n>" for PCs
+ * outside the histogram and "@S stop <mcause>" if an unexpected trap
+ * ended sampling early. ecalls are passed through to the previous trap
+ * vector and do not end sampling. If .text (__text_start..__text_end)
+ * is larger than the histogram covers, sample_report() says so first.
+ * host/sample_report.sh maps the PCs to functions and labels of the
+ * ELF.
+ *
+ * Needs machine mode and a CLINT-style timer (rv32emu system mode);
+ * SAMPLE_MTIME and SAMPLE_MTIMECMP override the register addresses.
+ */
+#include <stdint.h>
+
+void sample_start(void);
+void sample_stop(void);
+void sample_report(void);
+
+#endif /* SAMPLE_H */
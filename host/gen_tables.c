@@ -0,0 +1,184 @@
+/* Build-time generator of the kernels' lookup tables.
+ *
+ * Usage: gen_tables rsqrt <shift>            > rsqrt_table.h
+ *        gen_tables uf8 <decode_bits> <clz_bits> > uf8_tables.h
+ *
+ * rsqrt: 65536 / sqrt(x) at 2^shift points per octave, x = 2^e (1 + j /
+ *        2^shift), entry e << shift | j, 32 << shift entries (uint16_t,
+ *        the x = 1 entry clamped to 65535). shift 0 is the original
+ *        one-entry-per-power-of-two table.
+ * uf8:   uf8_decode_table, all 256 decoded values (decode_bits 8) or
+ *        the 16 per-exponent offsets (decode_bits 4); clz_table, leading
+ *        zeros of every clz_bits-bit value (2, 4, 8 or 16 bits).
+ *
+ * Every entry is checked against an exact reference (128-bit integer
+ * bounds for rsqrt) before anything is written; on a mismatch nothing
+ * is printed to stdout and the exit status is 1, which stops make.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <stdint.h>
+
+#define RSQRT_MAX_SHIFT 8
+
+typedef unsigned __int128 u128;
+
+/* y == round(65536 / sqrt(x)) for x = num / den, decided exactly:
+ * (2y - 1)^2 x <= 2^34 <= (2y + 1)^2 x
+ */
+static int rsqrt_entry_ok(uint32_t y, uint64_t num, uint64_t den)
+{
+    u128 lo = (u128) (2 * (uint64_t) y - 1) * (2 * (uint64_t) y - 1) * num;
+    u128 hi = (u128) (2 * (uint64_t) y + 1) * (2 * (uint64_t) y + 1) * num;
+    u128 target = (u128) den << 34;
+
+    return lo <= target && target <= hi;
+}
+
+static int gen_rsqrt(unsigned shift)
+{
+    unsigned steps = 1u << shift, size = 32u << shift;
+    uint16_t *table = malloc(size * sizeof(*table));
+
+    if (!table) {
+        perror("malloc");
+        return 0;
+    }
+    for (unsigned i = 0; i < size; i++) {
+        unsigned e = i >> shift, j = i & (steps - 1);
+        /* x = (steps + j) * 2^e / steps */
+        uint64_t num = (uint64_t) (steps + j) << e, den = steps;
+        long double x = (long double) num / den;
+        uint32_t y = (uint32_t) llroundl(65536.0L / sqrtl(x));
+
+        if (!rsqrt_entry_ok(y, num, den)) {
+            fprintf(stderr, "gen_tables: rsqrt entry %u (x = %.6Lf): %u\n", i,
+                    x, y);
+            free(table);
+            return 0;
+        }
+        table[i] = y > 0xFFFF ? 0xFFFF : y;
+    }
+
+    printf("/* Generated by host/gen_tables rsqrt %u, do not edit.\n", shift);
+    printf(" *\n");
+    printf(" * round(65536 / sqrt(x)) at x = 2^e * (1 + j / %u), index\n",
+           steps);
+    printf(" * e << RSQRT_TABLE_SHIFT | j; 65536 (x = 1) is stored as 65535.\n");
+    printf(" */\n");
+    printf("#define RSQRT_TABLE_SHIFT %u\n", shift);
+    printf("#define RSQRT_TABLE_SIZE %u\n\n", size);
+    printf("static const uint16_t rsqrt_table[RSQRT_TABLE_SIZE] = {\n");
+    for (unsigned e = 0; e < 32; e++) {
+        printf("   ");
+        for (unsigned j = 0; j < steps; j++) {
+            if (j && (j & 7) == 0)
+                printf("\n   ");
+            printf(" %5u,", table[e << shift | j]);
+        }
+        printf(" /* 2^%u */\n", e);
+    }
+    printf("};\n");
+    free(table);
+    return 1;
+}
+
+/* Decoded value by summing the exponent series, not the shift formula */
+static uint32_t uf8_reference(unsigned fl)
+{
+    uint64_t offset = 0, scale = 1;
+
+    for (unsigned e = 0; e < (fl >> 4); e++) {
+        offset += 16 * scale;
+        scale *= 2;
+    }
+    return (uint32_t) ((fl & 15) * scale + offset);
+}
+
+static unsigned clz_reference(unsigned v, unsigned bits)
+{
+    unsigned n = 0;
+
+    for (int b = bits - 1; b >= 0 && !((v >> b) & 1); b--)
+        n++;
+    return n;
+}
+
+static int gen_uf8(unsigned decode_bits, unsigned clz_bits)
+{
+    unsigned clz_size = 1u << clz_bits;
+
+    for (unsigned fl = 0; fl < 256; fl++) {
+        uint32_t v = ((fl & 15) << (fl >> 4)) + (((1u << (fl >> 4)) - 1) << 4);
+        if (v != uf8_reference(fl)) {
+            fprintf(stderr, "gen_tables: uf8 entry %02x: %u\n", fl, v);
+            return 0;
+        }
+    }
+    for (unsigned v = 1; v < clz_size; v++) {
+        if ((unsigned) __builtin_clz(v) - (32 - clz_bits) !=
+            clz_reference(v, clz_bits)) {
+            fprintf(stderr, "gen_tables: clz entry %u\n", v);
+            return 0;
+        }
+    }
+
+    printf("/* Generated by host/gen_tables uf8 %u %u, do not edit. */\n",
+           decode_bits, clz_bits);
+    printf("#define UF8_DECODE_BITS %u\n", decode_bits);
+    printf("#define CLZ_TABLE_BITS %u\n\n", clz_bits);
+    if (decode_bits == 8) {
+        printf("/* uf8_decode(fl) */\n");
+        printf("static const uint32_t uf8_decode_table[256] = {\n");
+        for (unsigned fl = 0; fl < 256; fl++)
+            printf("%s%u,%s", (fl & 7) ? " " : "    ", uf8_reference(fl),
+                   (fl & 7) == 7 ? "\n" : "");
+    } else {
+        printf("/* uf8_decode(e << 4): (2^e - 1) * 16 */\n");
+        printf("static const uint32_t uf8_decode_table[16] = {\n");
+        for (unsigned e = 0; e < 16; e++)
+            printf("%s%u,%s", (e & 7) ? " " : "    ", uf8_reference(e << 4),
+                   (e & 7) == 7 ? "\n" : "");
+    }
+    printf("};\n\n");
+    printf("/* Leading zeros of a %u-bit value; entry 0 is %u */\n", clz_bits,
+           clz_bits);
+    printf("static const uint8_t clz_table[%u] = {\n", clz_size);
+    for (unsigned v = 0; v < clz_size; v++)
+        printf("%s%u,%s", (v & 15) ? " " : "    ", clz_reference(v, clz_bits),
+               (v & 15) == 15 || v == clz_size - 1 ? "\n" : "");
+    printf("};\n");
+    return 1;
+}
+
+static int usage(void)
+{
+    fprintf(stderr, "usage: gen_tables rsqrt <shift 0..%d>\n"
+                    "       gen_tables uf8 <decode_bits 4|8> "
+                    "<clz_bits 2|4|8|16>\n",
+            RSQRT_MAX_SHIFT);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 3 && strcmp(argv[1], "rsqrt") == 0) {
+        unsigned shift = strtoul(argv[2], NULL, 0);
+        if (shift > RSQRT_MAX_SHIFT)
+            return usage();
+        return gen_rsqrt(shift) ? 0 : 1;
+    }
+    if (argc == 4 && strcmp(argv[1], "uf8") == 0) {
+        unsigned decode_bits = strtoul(argv[2], NULL, 0);
+        unsigned clz_bits = strtoul(argv[3], NULL, 0);
+        if ((decode_bits != 4 && decode_bits != 8) ||
+            (clz_bits != 2 && clz_bits != 4 && clz_bits != 8 &&
+             clz_bits != 16))
+            return usage();
+        return gen_uf8(decode_bits, clz_bits) ? 0 : 1;
+    }
+    return usage();
+}
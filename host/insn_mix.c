@@ -0,0 +1,594 @@
+/* Static instruction mix and code size of the RV32I images.
+ *
+ * Usage: insn_mix [-b] [-f function] elf
+ *        insn_mix -d [-a] [-b] [-f function] old.elf new.elf
+ *
+ *   -b  also list the basic blocks of every function
+ *   -f  only this function
+ *   -d  compare two builds of the same program: per function (and with
+ *       -b per block) the change in every column, changed entries only
+ *   -a  with -d, list unchanged entries too
+ *
+ * The ELF is decoded directly, no objdump needed. Functions are the FUNC
+ * or global symbols of .text and run up to the next one; every other
+ * .text symbol (the local labels of the .S files, e.g. state_loop) is a
+ * label. A basic block starts at a function, a label, a branch or jal
+ * target inside the function, or after a branch or jump, and is named
+ * after its label or as function+offset.
+ *
+ * Columns: code size in bytes, instruction count, then the count per
+ * class: alu (OP, OP-IMM, LUI, AUIPC), ls (loads and stores), br
+ * (conditional branches), jmp (jal, jalr), ecall, csr (Zicsr) and other
+ * (fence, ebreak, mret, anything undecoded). frame is the largest
+ * "addi sp, sp, -n" of the function; spill and reload count the stores
+ * to and loads from sp-relative slots, callee-saved registers included.
+ */
+#include <elf.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME_LEN 48
+
+enum insn_class {
+    CL_ALU,
+    CL_LS,
+    CL_BRANCH,
+    CL_JUMP,
+    CL_ECALL,
+    CL_CSR,
+    CL_OTHER,
+    CL_COUNT,
+};
+
+static const char *const class_names[CL_COUNT] = {
+    "alu", "ls", "br", "jmp", "ecall", "csr", "other",
+};
+
+/* Everything a row of the report shows */
+struct mix {
+    uint32_t insns;
+    uint32_t cls[CL_COUNT];
+    uint32_t bytes;
+    uint32_t frame;
+    uint32_t spills;
+    uint32_t reloads;
+};
+
+struct sym {
+    uint32_t addr;
+    int is_func;
+    char name[NAME_LEN];
+};
+
+struct block {
+    char name[NAME_LEN];
+    uint32_t start;
+    struct mix mix;
+};
+
+struct func {
+    char name[NAME_LEN];
+    uint32_t start, end;
+    struct mix mix;
+    struct block *blocks;
+    unsigned nblocks;
+};
+
+struct image {
+    const char *path;
+    uint8_t *file;
+    const uint8_t *text;
+    uint32_t text_addr, text_size;
+    struct sym *syms;
+    unsigned nsyms;
+    struct func *funcs;
+    unsigned nfuncs;
+};
+
+/* --- ELF loading --- */
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (len = ftell(f)) < 0 ||
+        fseek(f, 0, SEEK_SET) != 0) {
+        perror(path);
+        fclose(f);
+        return NULL;
+    }
+    buf = malloc(len ? len : 1);
+    if (!buf || fread(buf, 1, len, f) != (size_t) len) {
+        fprintf(stderr, "%s: read failed\n", path);
+        free(buf);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size = len;
+    return buf;
+}
+
+static int sym_cmp(const void *a, const void *b)
+{
+    const struct sym *x = a, *y = b;
+
+    if (x->addr != y->addr)
+        return x->addr < y->addr ? -1 : 1;
+    /* At a shared address the function comes first and wins */
+    return y->is_func - x->is_func;
+}
+
+static int load_image(struct image *img, const char *path)
+{
+    size_t size;
+    const Elf32_Ehdr *eh;
+    const Elf32_Shdr *sh;
+    unsigned text_idx = 0, symtab_idx = 0;
+
+    memset(img, 0, sizeof(*img));
+    img->path = path;
+    img->file = read_file(path, &size);
+    if (!img->file)
+        return 0;
+
+    eh = (const Elf32_Ehdr *) img->file;
+    if (size < sizeof(*eh) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS32 ||
+        eh->e_ident[EI_DATA] != ELFDATA2LSB || eh->e_machine != EM_RISCV) {
+        fprintf(stderr, "%s: not a little-endian RV32 ELF\n", path);
+        return 0;
+    }
+    if (eh->e_shoff + (size_t) eh->e_shnum * sizeof(Elf32_Shdr) > size ||
+        eh->e_shstrndx >= eh->e_shnum) {
+        fprintf(stderr, "%s: bad section table\n", path);
+        return 0;
+    }
+    sh = (const Elf32_Shdr *) (img->file + eh->e_shoff);
+
+    const char *shstr = (const char *) img->file +
+                        sh[eh->e_shstrndx].sh_offset;
+    for (unsigned i = 1; i < eh->e_shnum; i++) {
+        if (strcmp(shstr + sh[i].sh_name, ".text") == 0)
+            text_idx = i;
+        else if (sh[i].sh_type == SHT_SYMTAB)
+            symtab_idx = i;
+    }
+    if (!text_idx || !symtab_idx) {
+        fprintf(stderr, "%s: no .text or no symbol table\n", path);
+        return 0;
+    }
+    img->text = img->file + sh[text_idx].sh_offset;
+    img->text_addr = sh[text_idx].sh_addr;
+    img->text_size = sh[text_idx].sh_size;
+
+    const Elf32_Sym *st = (const Elf32_Sym *) (img->file +
+                                               sh[symtab_idx].sh_offset);
+    const char *strtab = (const char *) img->file +
+                         sh[sh[symtab_idx].sh_link].sh_offset;
+    unsigned n = sh[symtab_idx].sh_size / sizeof(Elf32_Sym);
+
+    img->syms = calloc(n ? n : 1, sizeof(struct sym));
+    if (!img->syms)
+        return 0;
+    for (unsigned i = 0; i < n; i++) {
+        const char *name = strtab + st[i].st_name;
+        unsigned type = ELF32_ST_TYPE(st[i].st_info);
+
+        if (st[i].st_shndx != text_idx || name[0] == '\0' || name[0] == '$' ||
+            strncmp(name, ".L", 2) == 0 ||
+            (type != STT_FUNC && type != STT_NOTYPE))
+            continue;
+        struct sym *s = &img->syms[img->nsyms++];
+        s->addr = st[i].st_value;
+        s->is_func = type == STT_FUNC ||
+                     ELF32_ST_BIND(st[i].st_info) == STB_GLOBAL;
+        snprintf(s->name, NAME_LEN, "%s", name);
+    }
+    qsort(img->syms, img->nsyms, sizeof(struct sym), sym_cmp);
+
+    /* One symbol per address */
+    unsigned out = 0;
+    for (unsigned i = 0; i < img->nsyms; i++) {
+        if (out && img->syms[out - 1].addr == img->syms[i].addr)
+            continue;
+        img->syms[out++] = img->syms[i];
+    }
+    img->nsyms = out;
+    return 1;
+}
+
+/* --- Decoding --- */
+
+static uint32_t insn_at(const struct image *img, uint32_t addr)
+{
+    const uint8_t *p = img->text + (addr - img->text_addr);
+    uint32_t w = p[0] | (p[1] << 8);
+
+    /* A compressed instruction may be the last halfword of .text */
+    if ((w & 3) == 3 && addr + 4 <= img->text_addr + img->text_size)
+        w |= (uint32_t) (p[2] | (p[3] << 8)) << 16;
+    return w;
+}
+
+static unsigned insn_len(uint32_t w)
+{
+    return (w & 3) == 3 ? 4 : 2;
+}
+
+static enum insn_class classify(uint32_t w)
+{
+    if (insn_len(w) == 2)
+        return CL_OTHER;
+    switch (w & 0x7f) {
+    case 0x13: /* OP-IMM */
+    case 0x33: /* OP */
+    case 0x37: /* LUI */
+    case 0x17: /* AUIPC */
+        return CL_ALU;
+    case 0x03: /* LOAD */
+    case 0x23: /* STORE */
+        return CL_LS;
+    case 0x63:
+        return CL_BRANCH;
+    case 0x6f: /* JAL */
+    case 0x67: /* JALR */
+        return CL_JUMP;
+    case 0x73: /* SYSTEM */
+        if ((w >> 12) & 7)
+            return CL_CSR;
+        return w == 0x00000073 ? CL_ECALL : CL_OTHER;
+    default:
+        return CL_OTHER;
+    }
+}
+
+static int32_t branch_offset(uint32_t w)
+{
+    uint32_t imm = ((w >> 31) & 1) << 12 | ((w >> 7) & 1) << 11 |
+                   ((w >> 25) & 0x3f) << 5 | ((w >> 8) & 0xf) << 1;
+    return (int32_t) (imm << 19) >> 19;
+}
+
+static int32_t jal_offset(uint32_t w)
+{
+    uint32_t imm = ((w >> 31) & 1) << 20 | ((w >> 12) & 0xff) << 12 |
+                   ((w >> 20) & 1) << 11 | ((w >> 21) & 0x3ff) << 1;
+    return (int32_t) (imm << 11) >> 11;
+}
+
+static void add_insn(struct mix *m, uint32_t w)
+{
+    uint32_t op = w & 0x7f, rd = (w >> 7) & 31, f3 = (w >> 12) & 7;
+    uint32_t rs1 = (w >> 15) & 31;
+
+    m->insns++;
+    m->bytes += insn_len(w);
+    m->cls[classify(w)]++;
+    if (insn_len(w) == 2)
+        return;
+    if (op == 0x13 && f3 == 0 && rd == 2 && rs1 == 2) {
+        int32_t imm = (int32_t) w >> 20;
+        if (imm < 0 && (uint32_t) -imm > m->frame)
+            m->frame = -imm;
+    } else if (op == 0x23 && rs1 == 2) {
+        m->spills++;
+    } else if (op == 0x03 && rs1 == 2) {
+        m->reloads++;
+    }
+}
+
+static void add_mix(struct mix *dst, const struct mix *src)
+{
+    dst->insns += src->insns;
+    dst->bytes += src->bytes;
+    for (int c = 0; c < CL_COUNT; c++)
+        dst->cls[c] += src->cls[c];
+    if (src->frame > dst->frame)
+        dst->frame = src->frame;
+    dst->spills += src->spills;
+    dst->reloads += src->reloads;
+}
+
+/* --- Functions and blocks --- */
+
+static const struct sym *label_at(const struct image *img, uint32_t addr)
+{
+    unsigned lo = 0, hi = img->nsyms;
+
+    while (lo < hi) {
+        unsigned mid = (lo + hi) / 2;
+        if (img->syms[mid].addr < addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < img->nsyms && img->syms[lo].addr == addr ? &img->syms[lo]
+                                                         : NULL;
+}
+
+static int analyse_func(const struct image *img, struct func *fn)
+{
+    uint32_t len = fn->end - fn->start;
+    /* One flag per halfword: does a block start here? */
+    uint8_t *leader = calloc(len / 2 + 1, 1);
+    uint32_t pc, w;
+
+    if (!leader)
+        return 0;
+    leader[0] = 1;
+    for (pc = fn->start; pc < fn->end; pc += insn_len(w)) {
+        int32_t off = 0;
+        int ends = 0;
+
+        w = insn_at(img, pc);
+        if (label_at(img, pc))
+            leader[(pc - fn->start) / 2] = 1;
+        if ((w & 0x7f) == 0x63) {
+            off = branch_offset(w);
+            ends = 1;
+        } else if ((w & 0x7f) == 0x6f) {
+            off = jal_offset(w);
+            ends = 1;
+        } else if ((w & 0x7f) == 0x67) {
+            ends = 1;
+        }
+        if (off) {
+            uint32_t target = pc + off;
+            if (target >= fn->start && target < fn->end)
+                leader[(target - fn->start) / 2] = 1;
+        }
+        if (ends && pc + insn_len(w) < fn->end)
+            leader[(pc + insn_len(w) - fn->start) / 2] = 1;
+    }
+
+    for (uint32_t i = 0; i <= len / 2; i++)
+        fn->nblocks += leader[i];
+    fn->blocks = calloc(fn->nblocks, sizeof(struct block));
+    if (!fn->blocks) {
+        free(leader);
+        return 0;
+    }
+
+    struct block *b = NULL;
+    for (pc = fn->start; pc < fn->end; pc += insn_len(w)) {
+        w = insn_at(img, pc);
+        if (leader[(pc - fn->start) / 2]) {
+            const struct sym *s = label_at(img, pc);
+            b = b ? b + 1 : fn->blocks;
+            b->start = pc;
+            if (s)
+                snprintf(b->name, NAME_LEN, "%s", s->name);
+            else
+                snprintf(b->name, NAME_LEN, "%.*s+0x%" PRIx32, NAME_LEN - 12,
+                         fn->name, pc - fn->start);
+        }
+        add_insn(&b->mix, w);
+    }
+    for (unsigned i = 0; i < fn->nblocks; i++)
+        add_mix(&fn->mix, &fn->blocks[i].mix);
+    free(leader);
+    return 1;
+}
+
+static int analyse(struct image *img)
+{
+    uint32_t text_end = img->text_addr + img->text_size;
+
+    img->funcs = calloc(img->nsyms ? img->nsyms : 1, sizeof(struct func));
+    if (!img->funcs)
+        return 0;
+    for (unsigned i = 0; i < img->nsyms; i++) {
+        const struct sym *s = &img->syms[i];
+        unsigned j;
+
+        if (!s->is_func || s->addr >= text_end)
+            continue;
+        for (j = i + 1; j < img->nsyms && !img->syms[j].is_func; j++)
+            ;
+        struct func *fn = &img->funcs[img->nfuncs++];
+        snprintf(fn->name, NAME_LEN, "%s", s->name);
+        fn->start = s->addr;
+        fn->end = j < img->nsyms && img->syms[j].addr < text_end
+                      ? img->syms[j].addr
+                      : text_end;
+        if (!analyse_func(img, fn))
+            return 0;
+    }
+    return 1;
+}
+
+/* --- Reports --- */
+
+static void print_header(const char *what)
+{
+    printf("%-32s %6s %6s", what, "bytes", "insns");
+    for (int c = 0; c < CL_COUNT; c++)
+        printf(" %5s", class_names[c]);
+    printf(" %5s %5s %6s\n", "frame", "spill", "reload");
+}
+
+static void print_row(const char *indent, const char *name,
+                      const struct mix *m)
+{
+    printf("%s%-*s %6" PRIu32 " %6" PRIu32, indent,
+           (int) (32 - strlen(indent)), name, m->bytes, m->insns);
+    for (int c = 0; c < CL_COUNT; c++)
+        printf(" %5" PRIu32, m->cls[c]);
+    printf(" %5" PRIu32 " %5" PRIu32 " %6" PRIu32 "\n", m->frame, m->spills,
+           m->reloads);
+}
+
+static void print_delta(const char *indent, const char *name,
+                        const struct mix *a, const struct mix *b,
+                        const char *note)
+{
+    printf("%s%-*s %+6" PRId32 " %+6" PRId32, indent,
+           (int) (32 - strlen(indent)), name, (int32_t) (b->bytes - a->bytes),
+           (int32_t) (b->insns - a->insns));
+    for (int c = 0; c < CL_COUNT; c++)
+        printf(" %+5" PRId32, (int32_t) (b->cls[c] - a->cls[c]));
+    printf(" %+5" PRId32 " %+5" PRId32 " %+6" PRId32 " %s\n",
+           (int32_t) (b->frame - a->frame), (int32_t) (b->spills - a->spills),
+           (int32_t) (b->reloads - a->reloads), note);
+}
+
+static int same_mix(const struct mix *a, const struct mix *b)
+{
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static int selected(const char *only, const char *name)
+{
+    return !only || strcmp(only, name) == 0;
+}
+
+static void report(const struct image *img, int blocks, const char *only)
+{
+    struct mix total = {0};
+
+    printf("%s: .text 0x%" PRIx32 ", %" PRIu32 " bytes\n\n", img->path,
+           img->text_addr, img->text_size);
+    print_header("function");
+    for (unsigned i = 0; i < img->nfuncs; i++) {
+        const struct func *fn = &img->funcs[i];
+
+        if (!selected(only, fn->name))
+            continue;
+        print_row("", fn->name, &fn->mix);
+        for (unsigned j = 0; blocks && j < fn->nblocks; j++)
+            print_row("  ", fn->blocks[j].name, &fn->blocks[j].mix);
+        add_mix(&total, &fn->mix);
+    }
+    print_row("", "total", &total);
+}
+
+static const struct func *find_func(const struct image *img, const char *name)
+{
+    for (unsigned i = 0; i < img->nfuncs; i++) {
+        if (strcmp(img->funcs[i].name, name) == 0)
+            return &img->funcs[i];
+    }
+    return NULL;
+}
+
+static const struct block *find_block(const struct func *fn, const char *name)
+{
+    for (unsigned i = 0; fn && i < fn->nblocks; i++) {
+        if (strcmp(fn->blocks[i].name, name) == 0)
+            return &fn->blocks[i];
+    }
+    return NULL;
+}
+
+static void diff_blocks(const struct func *a, const struct func *b, int all)
+{
+    static const struct mix none;
+
+    for (unsigned i = 0; a && i < a->nblocks; i++) {
+        const struct block *x = &a->blocks[i];
+        const struct block *y = find_block(b, x->name);
+
+        if (!y)
+            print_delta("  ", x->name, &x->mix, &none, "removed");
+        else if (all || !same_mix(&x->mix, &y->mix))
+            print_delta("  ", x->name, &x->mix, &y->mix, "");
+    }
+    for (unsigned i = 0; b && i < b->nblocks; i++) {
+        const struct block *y = &b->blocks[i];
+
+        if (!find_block(a, y->name))
+            print_delta("  ", y->name, &none, &y->mix, "new");
+    }
+}
+
+/* Rows are old -> new deltas; functions in only one build say so */
+static void diff(const struct image *a, const struct image *b, int blocks,
+                 int all, const char *only)
+{
+    static const struct mix none;
+    struct mix ta = {0}, tb = {0};
+
+    printf("%s -> %s\n\n", a->path, b->path);
+    print_header("function");
+    for (unsigned i = 0; i < a->nfuncs; i++) {
+        const struct func *x = &a->funcs[i];
+        const struct func *y = find_func(b, x->name);
+
+        if (!selected(only, x->name))
+            continue;
+        add_mix(&ta, &x->mix);
+        if (!y) {
+            print_delta("", x->name, &x->mix, &none, "removed");
+            continue;
+        }
+        if (!all && same_mix(&x->mix, &y->mix))
+            continue;
+        print_delta("", x->name, &x->mix, &y->mix, "");
+        if (blocks)
+            diff_blocks(x, y, all);
+    }
+    for (unsigned i = 0; i < b->nfuncs; i++) {
+        const struct func *y = &b->funcs[i];
+
+        if (!selected(only, y->name))
+            continue;
+        add_mix(&tb, &y->mix);
+        if (!find_func(a, y->name))
+            print_delta("", y->name, &none, &y->mix, "new");
+    }
+    print_delta("", "total", &ta, &tb, "");
+    printf("\nbytes %" PRIu32 " -> %" PRIu32 ", insns %" PRIu32 " -> %" PRIu32
+           "\n", ta.bytes, tb.bytes, ta.insns, tb.insns);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: insn_mix [-b] [-f function] elf\n"
+            "       insn_mix -d [-a] [-b] [-f function] old.elf new.elf\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    int blocks = 0, do_diff = 0, all = 0, i;
+    struct image img[2];
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        if (strcmp(argv[i], "-b") == 0) {
+            blocks = 1;
+        } else if (strcmp(argv[i], "-d") == 0) {
+            do_diff = 1;
+        } else if (strcmp(argv[i], "-a") == 0) {
+            all = 1;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (argc - i != (do_diff ? 2 : 1)) {
+        usage();
+        return 2;
+    }
+
+    for (int k = 0; k < argc - i; k++) {
+        if (!load_image(&img[k], argv[i + k]) || !analyse(&img[k]))
+            return 1;
+    }
+    if (do_diff)
+        diff(&img[0], &img[1], blocks, all, only);
+    else
+        report(&img[0], blocks, only);
+    return 0;
+}
@@ -0,0 +1,258 @@
+/* Host throughput benchmark of the C reference kernels.
+ *
+ * Usage: kernel_bench [-s samples] [kernel ...]
+ *
+ * Each sample times one batch of K calls with get_cycles (a nanosecond
+ * clock on the host, see perfcounter.h) over inputs drawn from a fixed
+ * xorshift sequence. The median of the empty-measurement cost is
+ * subtracted, and the median and min ns/op plus ops/s are reported for
+ * every batch size, so the timer overhead visible at K = 1 can be told
+ * apart from the kernel. A batch whose net time is below the clock
+ * resolution (clock_getres) prints "<res" instead of a figure. The
+ * references are checked against the
+ * expected values of the bare-metal suites before anything is timed.
+ *
+ * Kernels: clz mul32 uf8_decode uf8_encode fast_rsqrt hanoi_move_at
+ *          hanoi_pack (ops are moves of a 20-disk game, 8-bit records)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hanoi.h"
+#include "kernels.h"
+#include "perfcounter.h"
+
+#define INPUTS 4096 /* power of two, indexed with a mask */
+#define MAX_BATCH 4096
+#define WARMUP 8
+#define DEFAULT_SAMPLES 201
+#define PACK_DISKS 20
+
+static const unsigned batch_sizes[] = {1, 16, 256, MAX_BATCH};
+#define NUM_BATCHES (sizeof(batch_sizes) / sizeof(batch_sizes[0]))
+
+static uint32_t in_a[INPUTS], in_b[INPUTS];
+static uint8_t pack_buf[MAX_BATCH];
+static volatile uint32_t sink;
+
+static uint32_t xorshift32(uint32_t *s)
+{
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+/* Random magnitudes: clz and rsqrt take every branch */
+static void fill_inputs(void)
+{
+    uint32_t seed = 0x2545f491;
+
+    for (unsigned i = 0; i < INPUTS; i++) {
+        uint32_t r = xorshift32(&seed);
+        in_a[i] = r >> (xorshift32(&seed) & 31);
+        in_b[i] = xorshift32(&seed);
+    }
+}
+
+/* One batch of k calls starting at input i0 */
+typedef void (*batch_fn)(unsigned i0, unsigned k);
+
+#define DEFINE_BATCH(name, expr)                             \
+    static void batch_##name(unsigned i0, unsigned k)        \
+    {                                                        \
+        uint32_t acc = 0;                                    \
+        for (unsigned j = 0; j < k; j++) {                   \
+            uint32_t a = in_a[(i0 + j) & (INPUTS - 1)];      \
+            uint32_t b = in_b[(i0 + j) & (INPUTS - 1)];      \
+            (void) a, (void) b;                              \
+            acc += (expr);                                   \
+        }                                                    \
+        sink = acc;                                          \
+    }
+
+DEFINE_BATCH(clz, (uint32_t) clz(a))
+DEFINE_BATCH(mul32, (uint32_t) mul32(a, b))
+DEFINE_BATCH(uf8_decode, uf8_decode((uint8_t) b))
+DEFINE_BATCH(uf8_encode, uf8_encode(a >> 12))
+DEFINE_BATCH(fast_rsqrt, fast_rsqrt(a))
+DEFINE_BATCH(hanoi_move_at,
+             hanoi_move_at(HANOI_HOST_MAX_DISKS,
+                           (((uint64_t) a << 32 | b) >> 1) | 1))
+
+/* Start moves from which a full pack_buf of moves stays in the game */
+#define PACK_STARTS (HANOI_MOVES(PACK_DISKS) - sizeof(pack_buf) + 1)
+
+/* k consecutive moves from a random start, seeded in closed form */
+static void batch_hanoi_pack(unsigned i0, unsigned k)
+{
+    uint64_t k0 = 1 + in_b[i0 & (INPUTS - 1)] % PACK_STARTS;
+
+    hanoi_pack_range(PACK_DISKS, k0, k, pack_buf, HANOI_FMT_8BIT);
+    sink = pack_buf[k - 1];
+}
+
+static const struct kernel {
+    const char *name;
+    batch_fn fn;
+} kernels[] = {
+    {"clz", batch_clz},
+    {"mul32", batch_mul32},
+    {"uf8_decode", batch_uf8_decode},
+    {"uf8_encode", batch_uf8_encode},
+    {"fast_rsqrt", batch_fast_rsqrt},
+    {"hanoi_move_at", batch_hanoi_move_at},
+    {"hanoi_pack", batch_hanoi_pack},
+};
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t empty_ns(uint64_t *t, unsigned samples)
+{
+    for (unsigned s = 0; s < samples; s++) {
+        uint64_t t0 = get_cycles();
+        uint64_t t1 = get_cycles();
+        t[s] = t1 - t0;
+    }
+    qsort(t, samples, sizeof(*t), cmp_u64);
+    return t[samples / 2];
+}
+
+/* ns/op column, or "<res" if the net batch time was not resolved */
+static void print_ns(uint64_t net, unsigned k, uint64_t res)
+{
+    if (net < res)
+        printf(" %10s", "<res");
+    else
+        printf(" %10.2f", (double) net / k);
+}
+
+static void run_kernel(const struct kernel *kn, uint64_t *t,
+                       unsigned samples, uint64_t empty, uint64_t res)
+{
+    for (unsigned b = 0; b < NUM_BATCHES; b++) {
+        unsigned k = batch_sizes[b];
+        unsigned i0 = 0;
+
+        for (unsigned s = 0; s < WARMUP + samples; s++, i0 += k) {
+            uint64_t t0 = get_cycles();
+            kn->fn(i0, k);
+            uint64_t t1 = get_cycles();
+            if (s >= WARMUP)
+                t[s - WARMUP] = t1 - t0;
+        }
+        qsort(t, samples, sizeof(*t), cmp_u64);
+
+        uint64_t med = t[samples / 2] > empty ? t[samples / 2] - empty : 0;
+        uint64_t min = t[0] > empty ? t[0] - empty : 0;
+        printf("%-14s %6u", kn->name, k);
+        print_ns(med, k, res);
+        print_ns(min, k, res);
+        if (med < res)
+            printf(" %14s\n", "-");
+        else
+            printf(" %14.0f\n", 1e9 * k / med);
+    }
+}
+
+/* Expected values of q1-uf8/q1-uf8.S and q3-rsqrt/main.c */
+static int check_references(void)
+{
+    static const uint32_t rsqrt_exact[][2] = {
+        {0, 0xFFFFFFFF}, {1, 65536},    {0xFFFFFFFF, 1}, {4, 32768},
+        {16, 16384},     {1024, 2048},  {65536, 256},    {1048576, 64},
+    };
+    int32_t prev = -1;
+
+    for (unsigned i = 0; i < 256; i++) {
+        uint32_t v = uf8_decode(i);
+        if (uf8_encode(v) != i || (int32_t) v <= prev) {
+            fprintf(stderr, "uf8 reference: mismatch at %02x\n", i);
+            return 0;
+        }
+        prev = v;
+    }
+    for (unsigned i = 0; i < sizeof(rsqrt_exact) / sizeof(rsqrt_exact[0]);
+         i++) {
+        if (fast_rsqrt(rsqrt_exact[i][0]) != rsqrt_exact[i][1]) {
+            fprintf(stderr, "rsqrt reference: rsqrt(%u) = %u, expected %u\n",
+                    rsqrt_exact[i][0], fast_rsqrt(rsqrt_exact[i][0]),
+                    rsqrt_exact[i][1]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int selected(const char *name, char **names, int count)
+{
+    if (count == 0)
+        return 1;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned samples = DEFAULT_SAMPLES;
+    int first = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        samples = strtoul(argv[2], NULL, 0);
+        first = 3;
+    }
+    if (samples == 0) {
+        fprintf(stderr, "kernel_bench: samples must be positive\n");
+        return 2;
+    }
+    for (int i = first; i < argc; i++) {
+        unsigned j;
+        for (j = 0; j < NUM_KERNELS; j++) {
+            if (strcmp(argv[i], kernels[j].name) == 0)
+                break;
+        }
+        if (j == NUM_KERNELS) {
+            fprintf(stderr, "kernel_bench: unknown kernel '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!check_references())
+        return 1;
+    fill_inputs();
+
+    uint64_t *t = malloc(samples * sizeof(*t));
+    if (!t) {
+        perror("malloc");
+        return 1;
+    }
+    uint64_t empty = empty_ns(t, samples);
+    struct timespec rs;
+    uint64_t res = 1;
+
+    if (clock_getres(CLOCK_MONOTONIC, &rs) == 0 &&
+        (uint64_t) rs.tv_sec * 1000000000ULL + (uint64_t) rs.tv_nsec > 1)
+        res = (uint64_t) rs.tv_sec * 1000000000ULL + (uint64_t) rs.tv_nsec;
+
+    printf("empty measurement: %llu ns, resolution %llu ns, "
+           "%u samples per batch size\n",
+           (unsigned long long) empty, (unsigned long long) res, samples);
+    printf("%-14s %6s %10s %10s %14s\n", "kernel", "batch", "ns/op",
+           "min ns/op", "ops/s");
+    for (unsigned i = 0; i < NUM_KERNELS; i++) {
+        if (selected(kernels[i].name, argv + first, argc - first))
+            run_kernel(&kernels[i], t, samples, empty, res);
+    }
+    free(t);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/* C references of the q1-uf8 and q3-rsqrt kernels, see kernels.h.
+ * Keep in step with q1-uf8-test/q1-uf8.c and q3-rsqrt/main.c.
+ */
+#include "kernels.h"
+
+uint32_t uf8_decode(uint8_t fl)
+{
+    uint32_t mantissa = fl & 0x0f;
+    uint8_t exponent = fl >> 4;
+    uint32_t offset = (0x7FFF >> (15 - exponent)) << 4;
+    return (mantissa << exponent) + offset;
+}
+
+uint8_t uf8_encode(uint32_t value)
+{
+    if (value < 16)
+        return value;
+
+    int msb = 31 - clz(value);
+    uint8_t exponent = 0;
+    uint32_t overflow = 0;
+
+    if (msb >= 5) {
+        exponent = msb - 4;
+        if (exponent > 15)
+            exponent = 15;
+
+        for (uint8_t e = 0; e < exponent; e++)
+            overflow = (overflow << 1) + 16;
+
+        while (exponent > 0 && value < overflow) {
+            overflow = (overflow - 16) >> 1;
+            exponent--;
+        }
+    }
+
+    while (exponent < 15) {
+        uint32_t next_overflow = (overflow << 1) + 16;
+        if (value < next_overflow)
+            break;
+        overflow = next_overflow;
+        exponent++;
+    }
+
+    uint8_t mantissa = (value - overflow) >> exponent;
+    return (exponent << 4) | mantissa;
+}
+
+/* KERNELS_ASM_PRIMITIVES takes clz and mul32 from q3-rsqrt/compute.S
+ * instead, as the bare-metal q3 image does (bench/opt_matrix.sh).
+ */
+#ifndef KERNELS_ASM_PRIMITIVES
+int clz(uint32_t x)
+{
+    if (!x)
+        return 32;
+    int n = 0;
+    if (!(x & 0xFFFF0000)) { n += 16; x <<= 16; }
+    if (!(x & 0xFF000000)) { n += 8; x <<= 8; }
+    if (!(x & 0xF0000000)) { n += 4; x <<= 4; }
+    if (!(x & 0xC0000000)) { n += 2; x <<= 2; }
+    if (!(x & 0x80000000)) { n += 1; }
+    return n;
+}
+
+uint64_t mul32(uint32_t a, uint32_t b)
+{
+    uint64_t r = 0;
+    for (int i = 0; i < 32; i++) {
+        if (b & (1U << i))
+            r += (uint64_t) a << i;
+    }
+    return r;
+}
+#endif
+
+/* Generated by gen_tables, as in q3-rsqrt (make RSQRT_LUT_SHIFT=n) */
+#include "rsqrt_table.h"
+
+uint32_t fast_rsqrt(uint32_t x)
+{
+    if (x == 0)
+        return 0xFFFFFFFF;
+    if (x == 1)
+        return 65536;
+
+    int exp = 31 - clz(x);
+    uint32_t pos = (uint32_t) ((((uint64_t) x - (1UL << exp)) << 16) >> exp);
+    uint32_t idx = ((uint32_t) exp << RSQRT_TABLE_SHIFT) |
+                   (pos >> (16 - RSQRT_TABLE_SHIFT));
+    uint32_t y = rsqrt_table[idx];
+
+    if (x > (1u << exp)) {
+        uint32_t y_next =
+            (idx + 1 < RSQRT_TABLE_SIZE) ? rsqrt_table[idx + 1] : 0;
+        uint32_t delta = y - y_next;
+        uint32_t frac = (pos << RSQRT_TABLE_SHIFT) & 0xFFFF;
+        y -= (uint32_t) ((delta * frac) >> 16);
+        for (int iter = 0; iter < 2; iter++) {
+            uint32_t y2 = (uint32_t) mul32(y, y);
+            uint32_t xy2 = (uint32_t) (mul32(x, y2) >> 16);
+            y = (uint32_t) (mul32(y, (3u << 16) - xy2) >> 17);
+        }
+    }
+
+    return y;
+}
@@ -0,0 +1,18 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+/* C references of the q1-uf8 and q3-rsqrt kernels for the host build.
+ * The Hanoi reference is q2-hanoi/q2-hanoi-test/hanoi.c.
+ */
+#include <stdint.h>
+
+/* q1-uf8, as in q1-uf8-test/q1-uf8.c */
+uint32_t uf8_decode(uint8_t fl);
+uint8_t uf8_encode(uint32_t value);
+
+/* q3-rsqrt: the C bodies commented out next to compute.S's externs */
+int clz(uint32_t x);
+uint64_t mul32(uint32_t a, uint32_t b);
+uint32_t fast_rsqrt(uint32_t x);
+
+#endif /* KERNELS_H */
@@ -0,0 +1,202 @@
+/* Performance regression gate over the "@R" records of the test images
+ * (common/record.h, built with make RECORDS=1).
+ *
+ * Usage: perf_gate [-t percent] [-b baseline] [-u] [log ...]
+ *
+ *   -t  allowed cycle regression in percent (default 5)
+ *   -b  baseline file (default perf_baseline.txt)
+ *   -u  store the records of the logs as the new baseline
+ *
+ * Logs default to stdin; lines other than records are ignored, so the
+ * raw emulator output can be piped in. Without -u every record is
+ * compared with the baseline entry of the same id. The gate fails
+ * (exit 1) on any F record, on any id whose cycles grew by more than
+ * the threshold, and on baseline ids missing from the logs.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RECORDS 1024
+#define ID_LEN 64
+
+struct record {
+    char id[ID_LEN];
+    char status;
+    uint32_t cycles, instret, value;
+    int seen;
+};
+
+struct record_set {
+    struct record rec[MAX_RECORDS];
+    unsigned count;
+};
+
+static struct record_set current, baseline;
+
+static struct record *find(struct record_set *set, const char *id)
+{
+    for (unsigned i = 0; i < set->count; i++) {
+        if (strcmp(set->rec[i].id, id) == 0)
+            return &set->rec[i];
+    }
+    return NULL;
+}
+
+/* Adds the records in f; a repeated id keeps its last record */
+static int read_records(FILE *f, const char *name, struct record_set *set)
+{
+    char line[256];
+    unsigned lineno = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        struct record r = {0};
+
+        lineno++;
+        if (strncmp(line, "@R ", 3) != 0)
+            continue;
+        if (sscanf(line + 3, "%63s %c %" SCNx32 " %" SCNx32 " %" SCNx32,
+                   r.id, &r.status, &r.cycles, &r.instret, &r.value) != 5 ||
+            (r.status != 'P' && r.status != 'F')) {
+            fprintf(stderr, "%s:%u: malformed record\n", name, lineno);
+            return 0;
+        }
+
+        struct record *slot = find(set, r.id);
+        if (!slot) {
+            if (set->count == MAX_RECORDS) {
+                fprintf(stderr, "%s: more than %d records\n", name,
+                        MAX_RECORDS);
+                return 0;
+            }
+            slot = &set->rec[set->count++];
+        }
+        *slot = r;
+    }
+    return 1;
+}
+
+static int read_file(const char *path, struct record_set *set)
+{
+    FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    int ok;
+
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    ok = read_records(f, path, set);
+    if (f != stdin)
+        fclose(f);
+    return ok;
+}
+
+static int write_baseline(const char *path)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f) {
+        perror(path);
+        return 0;
+    }
+    for (unsigned i = 0; i < current.count; i++) {
+        const struct record *r = &current.rec[i];
+        fprintf(f, "@R %s %c %" PRIx32 " %" PRIx32 " %" PRIx32 "\n", r->id,
+                r->status, r->cycles, r->instret, r->value);
+    }
+    if (fclose(f) != 0) {
+        perror(path);
+        return 0;
+    }
+    printf("perf_gate: %u records stored in %s\n", current.count, path);
+    return 1;
+}
+
+static int compare(double threshold)
+{
+    int failed = 0;
+
+    printf("%-32s %4s %10s %10s %8s\n", "id", "", "baseline", "cycles",
+           "delta");
+    for (unsigned i = 0; i < current.count; i++) {
+        const struct record *r = &current.rec[i];
+        struct record *b = find(&baseline, r->id);
+        const char *verdict = "";
+
+        if (r->status == 'F') {
+            verdict = "FAILED";
+            failed = 1;
+        }
+        if (!b) {
+            printf("%-32s %4c %10s %10" PRIu32 " %8s %s\n", r->id, r->status,
+                   "-", r->cycles, "new", verdict);
+            continue;
+        }
+        b->seen = 1;
+        if (b->cycles == 0) {
+            printf("%-32s %4c %10" PRIu32 " %10" PRIu32 " %8s %s\n", r->id,
+                   r->status, b->cycles, r->cycles, "-", verdict);
+            continue;
+        }
+
+        double delta = 100.0 * ((double) r->cycles - b->cycles) / b->cycles;
+        if (delta > threshold) {
+            verdict = r->status == 'F' ? "FAILED, REGRESSION" : "REGRESSION";
+            failed = 1;
+        }
+        printf("%-32s %4c %10" PRIu32 " %10" PRIu32 " %+7.1f%% %s\n", r->id,
+               r->status, b->cycles, r->cycles, delta, verdict);
+    }
+    for (unsigned i = 0; i < baseline.count; i++) {
+        if (!baseline.rec[i].seen) {
+            printf("%-32s %4s %10" PRIu32 " %10s %8s MISSING\n",
+                   baseline.rec[i].id, "", baseline.rec[i].cycles, "-", "");
+            failed = 1;
+        }
+    }
+    printf("perf_gate: %s (threshold %.1f%%)\n", failed ? "FAILED" : "PASSED",
+           threshold);
+    return !failed;
+}
+
+int main(int argc, char **argv)
+{
+    const char *base_path = "perf_baseline.txt";
+    double threshold = 5.0;
+    int update = 0, i;
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        if (strcmp(argv[i], "-u") == 0) {
+            update = 1;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            threshold = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            base_path = argv[++i];
+        } else {
+            fprintf(stderr,
+                    "usage: perf_gate [-t percent] [-b baseline] [-u] "
+                    "[log ...]\n");
+            return 2;
+        }
+    }
+
+    if (i == argc) {
+        if (!read_records(stdin, "<stdin>", &current))
+            return 2;
+    }
+    for (; i < argc; i++) {
+        if (!read_file(argv[i], &current))
+            return 2;
+    }
+    if (current.count == 0) {
+        fprintf(stderr, "perf_gate: no records (build with RECORDS=1)\n");
+        return 2;
+    }
+
+    if (update)
+        return write_baseline(base_path) ? 0 : 2;
+    if (!read_file(base_path, &baseline))
+        return 2;
+    return compare(threshold) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#ifndef PERFCOUNTER_H
+#define PERFCOUNTER_H
+
+/* Host stand-ins for the counters in perfcounter.S. get_cycles reads
+ * CLOCK_MONOTONIC, so one "cycle" is one nanosecond here; there is no
+ * portable retired-instruction counter, so get_instret returns 0.
+ */
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t get_cycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static inline uint64_t get_instret(void)
+{
+    return 0;
+}
+
+#endif /* PERFCOUNTER_H */
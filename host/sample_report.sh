@@ -0,0 +1,122 @@
+#!/bin/sh
+# Flat profiles from a SAMPLE=1 run (common/sample.h): maps the "@S"
+# histogram lines of the log to the symbols of the ELF and prints the
+# samples per function and per label, most sampled first.
+#
+# Usage: CROSS_COMPILE=riscv-none-elf- ./sample_report.sh test.elf run.log
+#        (READELF overrides the readelf binary)
+#
+# A function is a FUNC or global symbol; every other text symbol is a
+# label (the local labels of the hand-written .S files, e.g.
+# state_loop), which also splits a function into its loops. A sample
+# belongs to the nearest symbol at or below its PC.
+set -e
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 <elf> <log>" >&2
+    exit 2
+fi
+ELF=$1
+LOG=$2
+READELF=${READELF:-${CROSS_COMPILE}readelf}
+
+SYMS=$(mktemp)
+trap 'rm -f "$SYMS"' EXIT
+
+# Section index of .text ("[ 1] .text ..." -> "1 .text ...")
+TEXT=$($READELF -SW "$ELF" |
+    sed -n 's/^ *\[ *\([0-9]*\)\] */\1 /p' |
+    awk '$2 == ".text" { print $1 }')
+if [ -z "$TEXT" ]; then
+    echo "$0: no .text in $ELF" >&2
+    exit 1
+fi
+
+# "<addr> <f|l> <name>", zero-padded hex so sort orders by address
+$READELF -sW "$ELF" |
+    awk -v ndx="$TEXT" '$7 == ndx && ($4 == "FUNC" || $4 == "NOTYPE") &&
+        $8 != "" && $8 !~ /^(\$|\.L)/ {
+            print $2, (($4 == "FUNC" || $5 == "GLOBAL") ? "f" : "l"), $8
+        }' |
+    sort -u -k1,1 >"$SYMS"
+
+awk '
+function hex(s,    i, v) {
+    v = 0
+    s = tolower(s)
+    for (i = 1; i <= length(s); i++)
+        v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+    return v
+}
+
+# Last symbol at or below pc, -1 if none
+function lookup(pc,    lo, hi, mid) {
+    lo = 0
+    hi = n - 1
+    if (n == 0 || pc < addr[0])
+        return -1
+    while (lo < hi) {
+        mid = int((lo + hi + 1) / 2)
+        if (addr[mid] <= pc)
+            lo = mid
+        else
+            hi = mid - 1
+    }
+    return lo
+}
+
+BEGIN { n = 0 }
+
+NR == FNR {
+    addr[n] = hex($1)
+    kind[n] = $2
+    name[n] = $3
+    n++
+    next
+}
+
+$1 != "@S" { next }
+$2 == "stop" { stop = $3; next }
+$2 == "other" { other = hex($3); total += other; next }
+{
+    c = hex($3)
+    total += c
+    i = lookup(hex($2))
+    if (i < 0) {
+        fn["?"] += c
+        lab["?"] += c
+        next
+    }
+    lab[name[i]] += c
+    while (i > 0 && kind[i] != "f")
+        i--
+    fn[kind[i] == "f" ? name[i] : "?"] += c
+}
+
+END {
+    if (total == 0) {
+        print "no samples (built with SAMPLE=1?)" > "/dev/stderr"
+        exit 1
+    }
+    for (s in fn)
+        printf "f %d %.1f %s\n", fn[s], fn[s] * 100 / total, s
+    for (s in lab)
+        printf "l %d %.1f %s\n", lab[s], lab[s] * 100 / total, s
+    printf "t %d %d %s\n", total, other, stop
+}
+' "$SYMS" "$LOG" |
+    sort -k1,1 -k2,2nr |
+    awk '
+$1 == "t" {
+    printf "\n%d samples, %d outside the histogram\n", $2, $3
+    if ($4 != "")
+        printf "sampling stopped early by trap cause 0x%s\n", $4
+    next
+}
+$1 != kind {
+    kind = $1
+    printf "%s%-28s %8s %6s\n", (NR > 1 ? "\n" : ""),
+        (kind == "f" ? "function" : "label"), "samples", "%"
+}
+{ printf "%-28s %8d %6.1f\n", $4, $2, $3 }
+'
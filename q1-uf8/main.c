@@ -1,6 +1,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+
+#include "arena.h"
+#include "bench.h"
+#include "prof.h"
+#include "prop.h"
+#include "record.h"
+#include "uf8_sort.h"
+
 #define printstr(ptr, length)                   \
 do {                                        \
     asm volatile(                           \
@@ -18,7 +26,7 @@ do {                                        \
 #define TEST_OUTPUT(msg, length) printstr(msg, length)
 #define TEST_LOGGER(msg)                     \
     {                                        \
-        char _msg[] = msg;                   \
+        static const char _msg[] = msg;      \
         TEST_OUTPUT(_msg, sizeof(_msg) - 1); \
     }
 
@@ -149,6 +157,222 @@ void print_dec(unsigned long val)
  * 0 = FAILED
  */
 extern int run_q1_uf8(void);
+extern uint32_t uf8_encode_abi(uint32_t value);
+extern uint32_t uf8_encode_abi_frame(uint32_t value);
+
+/* Benchmark inputs spanning exponents 0 to 15 */
+static struct bench_arg uf8_bench_args[] = {
+    {0, 0},       {15, 0},      {48, 0},       {240, 0},
+    {1008, 0},    {4080, 0},    {65520, 0},    {1015792, 0},
+};
+
+/* Generated by host/gen_tables (make UF8_DECODE_BITS=4|8 CLZ_TABLE_BITS=n) */
+#include "uf8_tables.h"
+
+static struct bench_arg code_bench_args[] = {
+    {0x00, 0}, {0x0f, 0}, {0x2a, 0}, {0x4f, 0},
+    {0x80, 0}, {0xa5, 0}, {0xd0, 0}, {0xff, 0},
+};
+
+/* Table-driven uf8_decode */
+static uint32_t uf8_decode_lut(uint32_t fl)
+{
+#if UF8_DECODE_BITS == 8
+    return uf8_decode_table[fl & 0xff];
+#else
+    uint32_t e = (fl >> 4) & 15;
+    return ((fl & 15) << e) + uf8_decode_table[e];
+#endif
+}
+
+/* Table-driven clz, CLZ_TABLE_BITS bits per step from the top */
+static uint32_t clz_lut(uint32_t x)
+{
+    uint32_t n = 0;
+
+    for (int shift = 32 - CLZ_TABLE_BITS; shift >= 0; shift -= CLZ_TABLE_BITS) {
+        uint32_t c = (x >> shift) & ((1u << CLZ_TABLE_BITS) - 1);
+        if (c)
+            return n + clz_table[c];
+        n += CLZ_TABLE_BITS;
+    }
+    return 32;
+}
+
+/* Typed bench_fn trampolines (common/bench.h) */
+BENCH_TRAMPOLINE(bench_uf8_encode, uf8_encode_abi(a))
+BENCH_TRAMPOLINE(bench_uf8_encode_frame, uf8_encode_abi_frame(a))
+BENCH_TRAMPOLINE(bench_uf8_decode_lut, uf8_decode_lut(a))
+BENCH_TRAMPOLINE(bench_clz_lut, clz_lut(a))
+
+/* The LUT decode must round-trip through the asm encoder */
+static int check_decode_lut(void)
+{
+    for (uint32_t fl = 0; fl < 256; fl++) {
+        if (uf8_encode_abi(uf8_decode_lut(fl)) != fl)
+            return 0;
+    }
+    return 1;
+}
+
+/* uf8 bucket sort against heap sort on the same inputs */
+#ifndef UF8_SORT_N
+#define UF8_SORT_N 1024
+#endif
+
+/* Sort buffers come from the linker heap (common/arena.h) */
+static struct arena heap;
+static uint32_t *sort_src, *sort_dst, *sort_ref;
+static uint8_t *sort_keys;
+
+static void run_q1_sort_case(const char *id_uf8, const char *id_heap,
+                             int skewed)
+{
+    uint32_t seed = PROP_SEED;
+    uint64_t c0, c1, c2, i0, i1, i2;
+    uint64_t part_cycles, uf8_cycles, uf8_instret;
+    uint64_t heap_cycles, heap_instret;
+    int ok = 1;
+
+    for (uint32_t i = 0; i < UF8_SORT_N; i++) {
+        sort_src[i] = skewed ? prop_rand_mag(&seed)
+                             : prop_rand(&seed) & 0xfffff;
+        sort_ref[i] = sort_src[i];
+    }
+
+    c0 = get_cycles();
+    uf8_partition(sort_src, sort_dst, sort_keys, UF8_SORT_N);
+    part_cycles = get_cycles() - c0;
+
+    i0 = get_instret();
+    c1 = get_cycles();
+    uf8_sort(sort_src, sort_dst, sort_keys, UF8_SORT_N);
+    c2 = get_cycles();
+    i1 = get_instret();
+    uf8_cycles = c2 - c1;
+    uf8_instret = i1 - i0;
+
+    c1 = get_cycles();
+    heap_sort(sort_ref, UF8_SORT_N);
+    c2 = get_cycles();
+    i2 = get_instret();
+    heap_cycles = c2 - c1;
+    heap_instret = i2 - i1;
+
+    for (uint32_t i = 0; i < UF8_SORT_N; i++) {
+        if (sort_dst[i] != sort_ref[i] ||
+            (i && sort_ref[i - 1] > sort_ref[i]))
+            ok = 0;
+    }
+
+    RECORD(id_uf8, ok, (uint32_t) uf8_cycles, (uint32_t) uf8_instret,
+           UF8_SORT_N);
+    RECORD(id_heap, ok, (uint32_t) heap_cycles, (uint32_t) heap_instret,
+           UF8_SORT_N);
+
+    if (skewed) {
+        TEST_LOGGER("  [sort] skewed   ");
+    } else {
+        TEST_LOGGER("  [sort] uniform  ");
+    }
+    TEST_LOGGER("partition: ");
+    print_dec((unsigned long) part_cycles);
+    TEST_LOGGER("  uf8_sort: ");
+    print_dec((unsigned long) uf8_cycles);
+    TEST_LOGGER("  heap_sort: ");
+    print_dec((unsigned long) heap_cycles);
+    TEST_LOGGER(" cycles, instret ");
+    print_dec((unsigned long) uf8_instret);
+    TEST_LOGGER(" / ");
+    print_dec((unsigned long) heap_instret);
+    if (ok) {
+        TEST_LOGGER("  PASSED\n");
+    } else {
+        TEST_LOGGER("  FAILED\n");
+    }
+}
+
+static void run_q1_sort(void)
+{
+    arena_mark_t mark = arena_mark(&heap);
+
+    TEST_LOGGER("\n  Sorting ");
+    print_dec(UF8_SORT_N);
+    TEST_LOGGER(" keys:\n");
+
+    sort_src = arena_alloc(&heap, UF8_SORT_N * sizeof(uint32_t));
+    sort_dst = arena_alloc(&heap, UF8_SORT_N * sizeof(uint32_t));
+    sort_ref = arena_alloc(&heap, UF8_SORT_N * sizeof(uint32_t));
+    sort_keys = arena_alloc(&heap, UF8_SORT_N);
+    if (!sort_src || !sort_dst || !sort_ref || !sort_keys) {
+        TEST_LOGGER("  [sort] heap too small\n");
+        arena_report(&heap);
+        arena_reset(&heap, mark);
+        return;
+    }
+
+    /* Random magnitudes (mostly small, as uf8 inputs) and 20-bit uniform */
+    run_q1_sort_case("q1.sort.skewed.uf8", "q1.sort.skewed.heap", 1);
+    run_q1_sort_case("q1.sort.uniform.uf8", "q1.sort.uniform.heap", 0);
+    arena_reset(&heap, mark);
+}
+
+#ifdef PROPTEST
+/* Random codes decode and encode back unchanged; random values encode
+ * to the largest code not above them (saturating at 0xff), and the
+ * encoder is monotonic.
+ */
+static void run_q1_props(void)
+{
+    struct prop_hist hist;
+    uint32_t seed = PROP_SEED;
+    uint32_t rt_failures = 0, rt_first = 0;
+    uint32_t mono_failures = 0, mono_first = 0;
+
+    prop_hist_reset(&hist);
+    for (uint32_t i = 0; i < PROP_ITERS; i++) {
+        uint32_t fl = prop_rand(&seed) & 0xff;
+        uint32_t v1 = prop_rand_mag(&seed), v2 = prop_rand_mag(&seed);
+        if (v1 > v2) {
+            uint32_t t = v1;
+            v1 = v2;
+            v2 = t;
+        }
+
+        uint32_t c0 = prop_cycles();
+        uint32_t e1 = uf8_encode_abi(v1);
+        uint32_t c1 = prop_cycles();
+        uint32_t e2 = uf8_encode_abi(v2);
+        prop_hist_add(&hist, c1 - c0);
+
+        if (uf8_encode_abi(uf8_decode_lut(fl)) != fl ||
+            uf8_decode_lut(e1) > v1 ||
+            (e1 < 0xff && v1 >= uf8_decode_lut(e1 + 1))) {
+            if (!rt_failures)
+                rt_first = v1;
+            rt_failures++;
+        }
+        if (e1 > e2) {
+            if (!mono_failures)
+                mono_first = v1;
+            mono_failures++;
+        }
+    }
+
+    TEST_LOGGER("\n  Property tests:\n");
+    prop_result("uf8 round trip", "q1.prop.uf8_roundtrip", PROP_ITERS,
+                rt_failures, rt_first);
+    prop_result("uf8 monotonic", "q1.prop.uf8_monotonic", PROP_ITERS,
+                mono_failures, mono_first);
+    prop_hist_report("uf8_encode", &hist);
+}
+#endif
+
+/* Profiling scope ids (common/prof.h); q1-uf8.S uses PROF_UF8_ENCODE */
+enum {
+    PROF_Q1_SUITE = 0,
+    PROF_UF8_ENCODE = 1,
+};
 
 int main(void)
 {
@@ -156,6 +380,11 @@ int main(void)
     uint64_t start_instret, end_instret, instret_elapsed;
 
     TEST_LOGGER("\n=== HW2 UF8 Tests (RISC-V Assembly) in Bare Metal ===\n\n");
+
+    arena_init_heap(&heap);
+
+    PROF_NAME(PROF_Q1_SUITE, "q1-uf8 suite");
+    PROF_NAME(PROF_UF8_ENCODE, "uf8_encode");
     
     start_cycles = get_cycles();
     start_instret = get_instret();
@@ -163,7 +392,9 @@ int main(void)
     /* * 呼叫您在 q1-uf8.s 中修改過的函式
      * C 語言會自動從 a0 暫存器讀取返回值
      */
+    PROF_BEGIN(PROF_Q1_SUITE);
     int passed = run_q1_uf8();
+    PROF_END(PROF_Q1_SUITE);
 
     end_cycles = get_cycles();
     end_instret = get_instret();
@@ -179,12 +410,38 @@ int main(void)
         TEST_LOGGER("  q1-uf8 Test Suite: FAILED\n");
     }
 
+    RECORD("q1.uf8.suite", passed, (uint32_t) cycles_elapsed,
+           (uint32_t) instret_elapsed, passed);
+
     TEST_LOGGER("  Cycles: ");
     print_dec((unsigned long) cycles_elapsed);
     TEST_LOGGER("  Instructions: ");
     print_dec((unsigned long) instret_elapsed);
     TEST_LOGGER("\n");
 
+    TEST_LOGGER("\n  Benchmarks (net cycles per call):\n");
+    /* uf8_encode_abi's own frame is in the baseline */
+    bench_run_base("uf8_encode", bench_uf8_encode, bench_uf8_encode_frame,
+                   uf8_bench_args, BENCH_NARGS(uf8_bench_args), 1);
+    bench_run_base("uf8_encode", bench_uf8_encode, bench_uf8_encode_frame,
+                   uf8_bench_args, BENCH_NARGS(uf8_bench_args), 8);
+    bench_run("uf8_decode_lut", bench_uf8_decode_lut, code_bench_args,
+              BENCH_NARGS(code_bench_args), 8);
+    bench_run("clz_lut", bench_clz_lut, uf8_bench_args,
+              BENCH_NARGS(uf8_bench_args), 8);
+
+    if (check_decode_lut()) {
+        TEST_LOGGER("  LUT decode round trip: PASSED\n");
+    } else {
+        TEST_LOGGER("  LUT decode round trip: FAILED\n");
+    }
+    arena_check(&heap, "q1.heap.check");
+    run_q1_sort();
+#ifdef PROPTEST
+    run_q1_props();
+#endif
+    arena_report(&heap);
+
     TEST_LOGGER("\n=== All Tests Completed ===\n");
 
     return 0;
@@ -0,0 +1,97 @@
+/* uf8 bucket sort, see uf8_sort.h.
+ *
+ * Keys come from q1-uf8.S's uf8_encode_abi, one call per value: the
+ * counting pass stores them in keys[] for the scatter pass. Nothing
+ * here multiplies or divides, so the image needs no M extension.
+ */
+#include "uf8_sort.h"
+
+extern uint32_t uf8_encode_abi(uint32_t value);
+
+uint32_t uf8_sort_start[257];
+
+void uf8_partition(const uint32_t *src, uint32_t *dst, uint8_t *keys,
+                   uint32_t n)
+{
+    uint32_t *start = uf8_sort_start;
+
+    for (uint32_t c = 0; c <= 256; c++)
+        start[c] = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t key = uf8_encode_abi(src[i]);
+        keys[i] = key;
+        start[key + 1]++;
+    }
+    for (uint32_t c = 0; c < 256; c++)
+        start[c + 1] += start[c];
+
+    /* Scatter with start[] as the write cursors; afterwards start[c]
+     * holds the end of bucket c, i.e. the table is one slot ahead.
+     */
+    for (uint32_t i = 0; i < n; i++)
+        dst[start[keys[i]]++] = src[i];
+    for (uint32_t c = 256; c > 0; c--)
+        start[c] = start[c - 1];
+    start[0] = 0;
+}
+
+static void insertion_sort(uint32_t *a, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t v = a[i];
+        uint32_t j = i;
+
+        while (j > 0 && a[j - 1] > v) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+static void sift_down(uint32_t *a, uint32_t root, uint32_t n)
+{
+    uint32_t v = a[root];
+
+    for (;;) {
+        uint32_t child = (root << 1) + 1;
+
+        if (child >= n)
+            break;
+        if (child + 1 < n && a[child + 1] > a[child])
+            child++;
+        if (a[child] <= v)
+            break;
+        a[root] = a[child];
+        root = child;
+    }
+    a[root] = v;
+}
+
+void heap_sort(uint32_t *a, uint32_t n)
+{
+    if (n < 2)
+        return;
+    for (uint32_t i = n >> 1; i-- > 0;)
+        sift_down(a, i, n);
+    for (uint32_t end = n - 1; end > 0; end--) {
+        uint32_t t = a[0];
+        a[0] = a[end];
+        a[end] = t;
+        sift_down(a, 0, end);
+    }
+}
+
+void uf8_sort(const uint32_t *src, uint32_t *dst, uint8_t *keys, uint32_t n)
+{
+    uf8_partition(src, dst, keys, n);
+    for (uint32_t c = 0; c < 256; c++) {
+        uint32_t lo = uf8_sort_start[c];
+        uint32_t len = uf8_sort_start[c + 1] - lo;
+
+        if (len <= UF8_SORT_INSERTION_MAX)
+            insertion_sort(dst + lo, len);
+        else
+            heap_sort(dst + lo, len);
+    }
+}
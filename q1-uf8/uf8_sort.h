@@ -0,0 +1,38 @@
+#ifndef UF8_SORT_H
+#define UF8_SORT_H
+
+/* Bucket sort of uint32 keys on their uf8 code.
+ *
+ * uf8_encode is monotonic, so its byte is a 256-bucket approximate key:
+ * a counting pass and a scatter pass put every value in its bucket in
+ * order, and each bucket then only needs sorting within itself.
+ * Buckets cover exponentially growing ranges (16 values per bucket
+ * below 16, then twice as wide per exponent), which matches the skewed,
+ * mostly-small inputs uf8 was made for. Values above 1015792 all share
+ * bucket 0xff.
+ */
+#include <stdint.h>
+
+/* Buckets up to this size finish with insertion sort, larger ones
+ * (e.g. the saturated top bucket) with heap sort.
+ */
+#define UF8_SORT_INSERTION_MAX 32
+
+/* Bucket bounds of the last uf8_partition: bucket c is
+ * dst[uf8_sort_start[c] .. uf8_sort_start[c + 1]).
+ */
+extern uint32_t uf8_sort_start[257];
+
+/* Approximate-order pass: copy src[0..n) to dst grouped by uf8 code,
+ * stable within a bucket. keys[0..n) is scratch for the codes.
+ */
+void uf8_partition(const uint32_t *src, uint32_t *dst, uint8_t *keys,
+                   uint32_t n);
+
+/* Exact sort: uf8_partition, then every bucket sorted in place */
+void uf8_sort(const uint32_t *src, uint32_t *dst, uint8_t *keys, uint32_t n);
+
+/* Plain in-place heap sort, the comparison-sort baseline */
+void heap_sort(uint32_t *a, uint32_t n);
+
+#endif /* UF8_SORT_H */
@@ -0,0 +1,160 @@
+/* Four-peg Hanoi solver, see hanoi4.h.
+ *
+ * The split table is built on first use. Generation is iterative: the
+ * Frame-Stewart recursion runs on an explicit stack of packed 32-bit
+ * frames (at most one per disk, 128 bytes), and each three-peg sub-tower
+ * uses the same Gray-code loop as hanoi.S, so the bare-metal stack use
+ * stays small whatever n is.
+ */
+#include "hanoi4.h"
+
+static uint8_t split_table[HANOI4_MAX_DISKS + 1];
+static uint32_t moves_table[HANOI4_MAX_DISKS + 1];
+static uint8_t tables_ready;
+
+/* (from << 2 | to) -> 4-bit pair code */
+static const uint8_t pair_codes4[16] = {
+    0, 0, 1, 2, /* A->B, A->C, A->D */
+    3, 0, 4, 5, /* B->A, B->C, B->D */
+    6, 7, 0, 8, /* C->A, C->B, C->D */
+    9, 10, 11, 0, /* D->A, D->B, D->C */
+};
+
+static void build_tables(void)
+{
+    moves_table[0] = 0;
+    for (uint32_t n = 1; n <= HANOI4_MAX_DISKS; n++) {
+        uint32_t best = 0xFFFFFFFF;
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t cost = (moves_table[k] << 1) + (1u << (n - k)) - 1;
+            if (cost < best) {
+                best = cost;
+                split_table[n] = k;
+            }
+        }
+        moves_table[n] = best;
+    }
+    tables_ready = 1;
+}
+
+uint32_t hanoi4_moves(uint32_t n)
+{
+    if (!tables_ready)
+        build_tables();
+    return moves_table[n];
+}
+
+uint32_t hanoi4_split(uint32_t n)
+{
+    if (!tables_ready)
+        build_tables();
+    return split_table[n];
+}
+
+struct stream_out {
+    uint8_t *p8;
+    uint32_t *p32;
+    uint32_t acc;
+    uint32_t shift;
+    uint32_t fmt;
+};
+
+static void emit(struct stream_out *o, uint32_t disk, uint32_t from,
+                 uint32_t to)
+{
+    uint32_t code = pair_codes4[from << 2 | to];
+
+    if (o->fmt == HANOI_FMT_8BIT4) {
+        *o->p8++ = disk << 4 | code;
+        return;
+    }
+    o->acc |= code << o->shift;
+    o->shift += 4;
+    if (o->shift == 32) {
+        *o->p32++ = o->acc;
+        o->acc = 0;
+        o->shift = 0;
+    }
+}
+
+/* Disks base .. base + m - 1 from 'src' to 'dst' over 'via' (3 pegs) */
+static void tower3(struct stream_out *o, uint32_t base, uint32_t m,
+                   uint32_t src, uint32_t via, uint32_t dst)
+{
+    uint8_t peg[3] = {src, via, dst};
+    uint8_t pos[HANOI4_MAX_DISKS + 1];
+    uint32_t step0 = (m & 1) + 1;
+    uint32_t end = 1u << m;
+
+    for (uint32_t d = 0; d < m; d++)
+        pos[d] = 0;
+
+    for (uint32_t k = 1; k != end; k++) {
+        uint32_t d = 0, from, to;
+        while (!((k >> d) & 1))
+            d++;
+
+        from = pos[d];
+        if (d == 0) {
+            to = from + step0;
+            if (to >= 3)
+                to -= 3;
+        } else {
+            to = 3 - from - pos[0];
+        }
+        pos[d] = to;
+        emit(o, base + d, peg[from], peg[to]);
+    }
+}
+
+/* Frame: n (bits 0-5), stage (6-7), src (8-9), dst (10-11),
+ * spare1 (12-13), spare2 (14-15)
+ */
+#define FRAME(n, s, d, a, b) ((n) | (s) << 8 | (d) << 10 | (a) << 12 | (b) << 14)
+#define FRAME_N(f) ((f) & 0x3f)
+#define FRAME_STAGE(f) (((f) >> 6) & 3)
+#define FRAME_PEG(f, i) (((f) >> (8 + 2 * (i))) & 3)
+
+uint32_t hanoi4_pack_moves(uint32_t n, void *buf, uint32_t fmt)
+{
+    uint32_t stack[HANOI4_MAX_DISKS + 1];
+    uint32_t sp = 0;
+    struct stream_out o = {buf, buf, 0, 0, fmt};
+
+    if (fmt == HANOI_FMT_8BIT4 && n > HANOI4_MAX_DISKS_8BIT)
+        return 0;
+    if (!tables_ready)
+        build_tables();
+
+    stack[sp++] = FRAME(n, 0, 3, 1, 2);
+    while (sp) {
+        uint32_t f = stack[sp - 1];
+        uint32_t fn = FRAME_N(f);
+        uint32_t k = split_table[fn];
+        uint32_t s = FRAME_PEG(f, 0), d = FRAME_PEG(f, 1);
+        uint32_t a = FRAME_PEG(f, 2), b = FRAME_PEG(f, 3);
+
+        if (fn == 0) {
+            sp--;
+            continue;
+        }
+
+        if (FRAME_STAGE(f) == 0) {
+            /* Top k disks to spare1, keeping dst and spare2 free */
+            stack[sp - 1] = f | 1 << 6;
+            stack[sp++] = FRAME(k, s, a, d, b);
+        } else if (FRAME_STAGE(f) == 1) {
+            /* The n - k larger disks with three pegs */
+            stack[sp - 1] = (f & ~(3u << 6)) | 2 << 6;
+            tower3(&o, k, fn - k, s, b, d);
+        } else {
+            /* Top k disks back onto dst: reuse this frame */
+            stack[sp - 1] = FRAME(k, a, d, s, b);
+        }
+    }
+
+    if (fmt != HANOI_FMT_8BIT4 && o.shift)
+        *o.p32 = o.acc;
+
+    return moves_table[n];
+}
@@ -0,0 +1,30 @@
+#ifndef HANOI4_H
+#define HANOI4_H
+
+/* Four-peg Tower of Hanoi (Reve's puzzle), tower A -> D, solved with the
+ * Frame-Stewart split. Builds for the bare-metal image and the host tools
+ * alike; moves are written in the stream formats of hanoi_stream.h.
+ */
+#include <stdint.h>
+
+#include "hanoi_stream.h"
+
+#define HANOI4_MAX_DISKS 31
+/* HANOI_FMT_8BIT4 keeps the disk in the top four bits of the byte */
+#define HANOI4_MAX_DISKS_8BIT 16
+
+/* Move count of the Frame-Stewart solution for n disks */
+uint32_t hanoi4_moves(uint32_t n);
+
+/* Optimal split: move the top k disks aside with four pegs, the other
+ * n - k with three pegs, then the k disks back on top.
+ */
+uint32_t hanoi4_split(uint32_t n);
+
+/* Write all moves of an n-disk game to buf in HANOI_FMT_4BIT or
+ * HANOI_FMT_8BIT4; returns the move count, or 0 without writing if n
+ * is above HANOI4_MAX_DISKS_8BIT for HANOI_FMT_8BIT4.
+ */
+uint32_t hanoi4_pack_moves(uint32_t n, void *buf, uint32_t fmt);
+
+#endif /* HANOI4_H */
@@ -0,0 +1,65 @@
+#ifndef HANOI_STREAM_H
+#define HANOI_STREAM_H
+
+/* Packed Hanoi move stream, shared by the bare-metal image and the host
+ * tools in q2-hanoi-test/.
+ *
+ * Pegs are numbered 0 = A, 1 = B, 2 = C and disks from 0 (the smallest).
+ * The tower starts on A and ends on C. An ordered (from, to) pair is
+ * stored as a 3-bit code:
+ *
+ *   0: A->B   1: A->C   2: B->A   3: B->C   4: C->A   5: C->B
+ *
+ * i.e. code = from * 2 + index of 'to' among the two other pegs.
+ *
+ * HANOI_FMT_8BIT: one byte per move, (disk << 3) | code (disks 0..31).
+ * HANOI_FMT_3BIT: the code only, ten codes per 32-bit little-endian word
+ *                 starting at bit 0 (bits 30-31 unused). The disk of move
+ *                 k (1-based) is ctz(k), so it does not need to be stored.
+ *
+ * The four-peg solver (hanoi4.h, tower A -> D) uses the same layout
+ * with 4-bit codes for its 12 ordered pairs:
+ *
+ *   code = from * 3 + index of 'to' among the three other pegs
+ *
+ * HANOI_FMT_4BIT:  the code only, eight codes per 32-bit word. The disk
+ *                  is not implied by k; a reader takes the top of 'from'.
+ * HANOI_FMT_8BIT4: one byte per move, (disk << 4) | code (disks 0..15).
+ *                  A separate id from HANOI_FMT_8BIT, whose disk field
+ *                  starts at bit 3, so a format id names one layout.
+ */
+
+#define HANOI_FMT_3BIT 3
+#define HANOI_FMT_4BIT 4
+#define HANOI_FMT_8BIT 8
+#define HANOI_FMT_8BIT4 9
+
+/* One byte per move (HANOI_FMT_8BIT or HANOI_FMT_8BIT4) */
+#define HANOI_FMT_BYTES(fmt) \
+    ((fmt) == HANOI_FMT_8BIT || (fmt) == HANOI_FMT_8BIT4)
+
+#define HANOI_CODES_PER_WORD 10
+#define HANOI_MAX_DISKS 31
+
+#define HANOI_PAIR_CODE(from, to) ((from) * 2 + ((to) > (from) ? (to) - 1 : (to)))
+#define HANOI_CODE_FROM(code) ((code) >> 1)
+#define HANOI_CODE_TO(code) \
+    (((code) & 1) + (((code) & 1) >= HANOI_CODE_FROM(code) ? 1 : 0))
+
+#define HANOI4_PAIR_CODE(from, to) \
+    ((from) * 3 + ((to) > (from) ? (to) - 1 : (to)))
+#define HANOI4_CODES_PER_WORD 8
+
+/* Bits per pair code for a 3- or 4-peg stream */
+#define HANOI_CODE_BITS(pegs) ((pegs) == 4 ? 4 : 3)
+
+#define HANOI_MOVES(n) ((1UL << (n)) - 1)
+
+/* Size of a stream holding all moves of an n-disk game */
+#define HANOI_STREAM_WORDS(n, fmt)                                      \
+    (HANOI_FMT_BYTES(fmt)                                               \
+         ? (HANOI_MOVES(n) + 3) / 4                                     \
+         : (HANOI_MOVES(n) + HANOI_CODES_PER_WORD - 1) / HANOI_CODES_PER_WORD)
+#define HANOI_STREAM_BYTES(n, fmt) (HANOI_STREAM_WORDS(n, fmt) * 4)
+
+#endif /* HANOI_STREAM_H */
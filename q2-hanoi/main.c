@@ -2,6 +2,13 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "arena.h"
+#include "hanoi4.h"
+#include "hanoi_stream.h"
+#include "prof.h"
+#include "prop.h"
+#include "record.h"
+
 #define printstr(ptr, length)                   \
     do {                                        \
         asm volatile(                           \
@@ -19,7 +26,7 @@
 
 #define TEST_LOGGER(msg)                     \
     {                                        \
-        char _msg[] = msg;                   \
+        static const char _msg[] = msg;      \
         TEST_OUTPUT(_msg, sizeof(_msg) - 1); \
     }
 
@@ -168,6 +175,284 @@ int itoa_dec(unsigned long val, char *buf)
     return len; // 返回寫入的長度
 }
 extern int run_q2_game_hanoi(void);
+extern uint32_t hanoi_print_moves(uint32_t n, char *buf, uint32_t size);
+
+/* Text output path for the 3-disk game:
+ * HANOI_TEXT_ECALL    - run_q2_game_hanoi, one ecall per field (default)
+ * HANOI_TEXT_TEMPLATE - hanoi_print_moves, each line byte-copied from a
+ *                       per-disk template into a buffer, one ecall per
+ *                       buffer (make EXTRA_CFLAGS=-DHANOI_TEXT_PATH=1)
+ */
+#define HANOI_TEXT_ECALL 0
+#define HANOI_TEXT_TEMPLATE 1
+#ifndef HANOI_TEXT_PATH
+#define HANOI_TEXT_PATH HANOI_TEXT_ECALL
+#endif
+#define HANOI_TEXT_DISKS 3
+
+#if HANOI_TEXT_PATH == HANOI_TEXT_TEMPLATE
+static char hanoi_line_buf[1024];
+#endif
+extern uint32_t hanoi_pack_moves(uint32_t n, void *buf, uint32_t fmt);
+extern uint32_t hanoi_move_at(uint32_t n, uint32_t k);
+extern void hanoi_state_at(uint32_t n, uint32_t k, uint32_t pegs[3]);
+extern uint32_t hanoi_verify(uint32_t n, const void *buf, uint32_t fmt,
+                             uint32_t moves, uint32_t pegs);
+
+/* Profiling scope ids (common/prof.h) */
+enum {
+    PROF_HANOI_TEXT,
+    PROF_HANOI_PACK,
+    PROF_HANOI_VERIFY,
+    PROF_HANOI4_PACK,
+    PROF_HANOI_MOVE_AT,
+    PROF_HANOI_STATE_AT,
+};
+
+/* Packed move-stream run (see hanoi_stream.h) */
+#ifndef HANOI_PACK_DISKS
+#define HANOI_PACK_DISKS 20
+#endif
+#ifndef HANOI_PACK_FMT
+#define HANOI_PACK_FMT HANOI_FMT_3BIT
+#endif
+
+/* Move buffers come from the linker heap (common/arena.h) */
+static struct arena heap;
+
+static uint32_t *hanoi_stream;
+
+#ifdef HANOI_DUMP_STREAM
+/* Write the raw stream to stderr, e.g. rv32emu test.elf 2> moves.bin */
+static void dump_stream(const void *buf, unsigned long len)
+{
+    asm volatile(
+        "add a7, x0, 0x40;"
+        "add a0, x0, 0x2;" /* stderr */
+        "add a1, x0, %0;"
+        "mv a2, %1;"
+        "ecall;"
+        :
+        : "r"(buf), "r"(len)
+        : "a0", "a1", "a2", "a7", "memory");
+}
+#endif
+
+/* Four-peg (Frame-Stewart) run */
+#ifndef HANOI4_DISKS
+#define HANOI4_DISKS 20
+#endif
+#ifndef HANOI4_FMT
+#define HANOI4_FMT HANOI_FMT_4BIT
+#endif
+_Static_assert(HANOI4_FMT != HANOI_FMT_8BIT4 ||
+                   HANOI4_DISKS <= HANOI4_MAX_DISKS_8BIT,
+               "HANOI_FMT_8BIT4 holds disks 1..16 only");
+
+static uint32_t *hanoi4_stream;
+
+#ifndef HANOI_CHECK_DISKS
+#define HANOI_CHECK_DISKS 10
+#endif
+
+/* Cross-check hanoi_move_at/hanoi_state_at against the sequential
+ * generator at every move of a HANOI_CHECK_DISKS game.
+ */
+static int check_moves_at(uint8_t *seq)
+{
+    uint32_t expect[3] = {HANOI_MOVES(HANOI_CHECK_DISKS), 0, 0};
+    uint32_t pegs[3];
+
+    uint32_t moves = hanoi_pack_moves(HANOI_CHECK_DISKS, seq, HANOI_FMT_8BIT);
+
+    for (uint32_t k = 1; k <= moves; k++) {
+        uint32_t rec = seq[k - 1];
+        uint32_t bit = 1u << (rec >> 3);
+
+        PROF_BEGIN(PROF_HANOI_MOVE_AT);
+        uint32_t got = hanoi_move_at(HANOI_CHECK_DISKS, k);
+        PROF_END(PROF_HANOI_MOVE_AT);
+        if (got != rec)
+            return 0;
+
+        expect[HANOI_CODE_FROM(rec & 7)] &= ~bit;
+        expect[HANOI_CODE_TO(rec & 7)] |= bit;
+        PROF_BEGIN(PROF_HANOI_STATE_AT);
+        hanoi_state_at(HANOI_CHECK_DISKS, k, pegs);
+        PROF_END(PROF_HANOI_STATE_AT);
+        if (pegs[0] != expect[0] || pegs[1] != expect[1] ||
+            pegs[2] != expect[2])
+            return 0;
+    }
+    return 1;
+}
+
+/* The reference sequence only lives for the check: mark/reset */
+static int check_random_access(void)
+{
+    arena_mark_t mark = arena_mark(&heap);
+    uint8_t *seq = arena_alloc(&heap, HANOI_MOVES(HANOI_CHECK_DISKS));
+    int ok = seq && check_moves_at(seq);
+
+    arena_reset(&heap, mark);
+    return ok;
+}
+
+/* Solver strategies (hanoi_strat.S), every move into a checksum sink:
+ * n = HANOI_STRAT_STEP, 2 * HANOI_STRAT_STEP, ... HANOI_STRAT_MAX_DISKS.
+ */
+#ifndef HANOI_STRAT_MAX_DISKS
+#define HANOI_STRAT_MAX_DISKS 16
+#endif
+#ifndef HANOI_STRAT_STEP
+#define HANOI_STRAT_STEP 4
+#endif
+
+extern uint32_t hanoi_solve_recursive(uint32_t n);
+extern uint32_t hanoi_solve_gray(uint32_t n);
+extern uint32_t hanoi_solve_bitboard(uint32_t n);
+
+/* Stack below the caller's sp is filled with this word before a run */
+#define STACK_PAINT 0x5a5af00d
+#define STACK_PAINT_BYTES 2048
+
+static const struct {
+    const char *name;
+    uint32_t (*solve)(uint32_t n);
+} hanoi_strategies[] = {
+    {"recursive", hanoi_solve_recursive},
+    {"gray", hanoi_solve_gray},
+    {"bitboard", hanoi_solve_bitboard},
+};
+#define HANOI_STRATEGIES \
+    (sizeof(hanoi_strategies) / sizeof(hanoi_strategies[0]))
+
+static uint32_t str_copy(char *dst, const char *src)
+{
+    uint32_t len = 0;
+
+    while (src[len] != '\0') {
+        dst[len] = src[len];
+        len++;
+    }
+    return len;
+}
+
+/* Cycles, instret and peak stack of every strategy at each n. The
+ * paint and the scan run in this frame: a helper's own frame would sit
+ * in the painted area. All strategies must agree on the checksum.
+ */
+static void run_q2_strategies(void)
+{
+    TEST_LOGGER("\n  Solver strategies (no output, checksum sink):\n");
+    for (uint32_t n = HANOI_STRAT_STEP; n <= HANOI_STRAT_MAX_DISKS;
+         n += HANOI_STRAT_STEP) {
+        uint32_t expect = 0;
+
+        for (uint32_t i = 0; i < HANOI_STRATEGIES; i++) {
+            volatile uint32_t *sp, *p, *low;
+            uint64_t c0, i0, cycles, instret;
+            uint32_t sum, depth;
+            char id[RECORD_ID_LEN];
+            uint32_t len;
+
+            asm volatile("mv %0, sp" : "=r"(sp));
+            low = sp - STACK_PAINT_BYTES / 4;
+            for (p = low; p < sp; p++)
+                *p = STACK_PAINT;
+
+            c0 = get_cycles();
+            i0 = get_instret();
+            sum = hanoi_strategies[i].solve(n);
+            instret = get_instret() - i0;
+            cycles = get_cycles() - c0;
+
+            for (p = low; p < sp && *p == STACK_PAINT; p++)
+                ;
+            depth = (uint32_t) (sp - p) << 2;
+
+            if (i == 0)
+                expect = sum;
+
+            len = str_copy(id, "q2.strat.");
+            len += str_copy(id + len, hanoi_strategies[i].name);
+            id[len++] = '.';
+            len += itoa_dec(n, id + len);
+            id[len] = '\0';
+            RECORD(id, sum == expect, (uint32_t) cycles, (uint32_t) instret,
+                   depth);
+
+            TEST_LOGGER("  [hanoi] ");
+            TEST_OUTPUT(id + 9, len - 9);
+            TEST_LOGGER("  cycles: ");
+            print_dec((unsigned long) cycles);
+            TEST_LOGGER("  instret: ");
+            print_dec((unsigned long) instret);
+            TEST_LOGGER("  stack: ");
+            print_dec(depth);
+            if (sum == expect) {
+                TEST_LOGGER(" bytes  PASSED\n");
+            } else {
+                TEST_LOGGER(" bytes  FAILED\n");
+            }
+        }
+    }
+}
+
+#ifdef PROPTEST
+/* Legality of move k of a random n-disk game, from hanoi_state_at alone:
+ * the moved disk is ctz(k), it is the top of 'from' before the move,
+ * 'to' holds nothing smaller, and the state after is the state before
+ * with that one disk moved.
+ */
+static void run_q2_props(void)
+{
+    struct prop_hist hist;
+    uint32_t seed = PROP_SEED;
+    uint32_t failures = 0, first_bad = 0;
+    uint32_t before[3], after[3];
+
+    prop_hist_reset(&hist);
+    for (uint32_t i = 0; i < PROP_ITERS; i++) {
+        uint32_t n = 1 + umod(prop_rand(&seed), HANOI_MAX_DISKS);
+        uint32_t k = prop_rand(&seed) & HANOI_MOVES(n);
+        if (!k)
+            k = 1;
+
+        uint32_t c0 = prop_cycles();
+        uint32_t rec = hanoi_move_at(n, k);
+        uint32_t c1 = prop_cycles();
+        prop_hist_add(&hist, c1 - c0);
+
+        uint32_t disk = rec >> 3;
+        uint32_t bit = 1u << disk;
+        uint32_t below = bit - 1;
+        uint32_t from = HANOI_CODE_FROM(rec & 7);
+        uint32_t to = HANOI_CODE_TO(rec & 7);
+
+        hanoi_state_at(n, k - 1, before);
+        hanoi_state_at(n, k, after);
+
+        int ok = (k & below) == 0 && (k & bit) != 0 &&
+                 (before[from] & (bit | below)) == bit &&
+                 (before[to] & below) == 0;
+        before[from] &= ~bit;
+        before[to] |= bit;
+        ok = ok && before[0] == after[0] && before[1] == after[1] &&
+             before[2] == after[2];
+        if (!ok) {
+            if (!failures)
+                first_bad = k;
+            failures++;
+        }
+    }
+
+    TEST_LOGGER("\n  Property tests:\n");
+    prop_result("hanoi legality", "q2.prop.hanoi_legality", PROP_ITERS,
+                failures, first_bad);
+    prop_hist_report("hanoi_move_at", &hist);
+}
+#endif
 
 int main(void)
 {
@@ -175,11 +460,30 @@ int main(void)
     uint64_t start_instret, end_instret, instret_elapsed;
 
     TEST_LOGGER("\n=== HW2 Game Hanoi Tests (RISC-V Assembly) in Bare Metal ===\n\n");
+
+    arena_init_heap(&heap);
+    arena_check(&heap, "q2.heap.check");
+
+    PROF_NAME(PROF_HANOI_TEXT, "hanoi text");
+    PROF_NAME(PROF_HANOI_PACK, "hanoi pack");
+    PROF_NAME(PROF_HANOI_VERIFY, "hanoi verify");
+    PROF_NAME(PROF_HANOI4_PACK, "hanoi4 pack");
+    PROF_NAME(PROF_HANOI_MOVE_AT, "hanoi_move_at");
+    PROF_NAME(PROF_HANOI_STATE_AT, "hanoi_state_at");
     
     start_cycles = get_cycles();
     start_instret = get_instret();
 
+    PROF_BEGIN(PROF_HANOI_TEXT);
+#if HANOI_TEXT_PATH == HANOI_TEXT_TEMPLATE
+    uint32_t text_moves = hanoi_print_moves(HANOI_TEXT_DISKS, hanoi_line_buf,
+                                            sizeof(hanoi_line_buf));
+    int passed = text_moves == HANOI_MOVES(HANOI_TEXT_DISKS);
+#else
+    uint32_t text_moves = HANOI_MOVES(HANOI_TEXT_DISKS);
     int passed = run_q2_game_hanoi();
+#endif
+    PROF_END(PROF_HANOI_TEXT);
 
     end_cycles = get_cycles();
     end_instret = get_instret();
@@ -189,6 +493,9 @@ int main(void)
     /* * 檢查來自組合語言的返回值，並使用 "正確" 的裸機
      * 系統呼叫 (TEST_LOGGER) 來印出結果。
      */
+    RECORD("q2.hanoi.text", passed, (uint32_t) cycles_elapsed,
+           (uint32_t) instret_elapsed, text_moves);
+
     if (passed) {
         TEST_LOGGER("\n  q2-hanoi Test Suite: PASSED\n");
     } else {
@@ -200,6 +507,149 @@ int main(void)
     TEST_LOGGER("  Instructions: ");
     print_dec((unsigned long) instret_elapsed);
     TEST_LOGGER("\n");
+#if HANOI_TEXT_PATH == HANOI_TEXT_TEMPLATE
+    TEST_LOGGER("  Text path: template");
+#else
+    TEST_LOGGER("  Text path: ecall per field");
+#endif
+    TEST_LOGGER("  Cycles/move: ");
+    print_dec(udiv((unsigned long) cycles_elapsed, text_moves));
+    TEST_LOGGER("\n");
+
+    /* Same solver, packed output: no ecall or print_dec per move */
+    TEST_LOGGER("\n  Packed move stream, disks: ");
+    print_dec(HANOI_PACK_DISKS);
+    TEST_LOGGER("  Format bits: ");
+    print_dec(HANOI_PACK_FMT);
+    TEST_LOGGER("\n");
+
+    hanoi_stream =
+        arena_alloc(&heap, HANOI_STREAM_BYTES(HANOI_PACK_DISKS, HANOI_PACK_FMT));
+    if (!hanoi_stream) {
+        TEST_LOGGER("  Packed move stream: heap too small\n");
+        arena_report(&heap);
+        return 0;
+    }
+
+    start_cycles = get_cycles();
+    start_instret = get_instret();
+
+    PROF_BEGIN(PROF_HANOI_PACK);
+    uint32_t moves =
+        hanoi_pack_moves(HANOI_PACK_DISKS, hanoi_stream, HANOI_PACK_FMT);
+    PROF_END(PROF_HANOI_PACK);
+
+    end_cycles = get_cycles();
+    end_instret = get_instret();
+    cycles_elapsed = end_cycles - start_cycles;
+    instret_elapsed = end_instret - start_instret;
+
+    RECORD("q2.hanoi.pack", moves == HANOI_MOVES(HANOI_PACK_DISKS),
+           (uint32_t) cycles_elapsed, (uint32_t) instret_elapsed, moves);
+
+    TEST_LOGGER("  Moves: ");
+    print_dec(moves);
+    TEST_LOGGER("  Cycles: ");
+    print_dec((unsigned long) cycles_elapsed);
+    TEST_LOGGER("  Instructions: ");
+    print_dec((unsigned long) instret_elapsed);
+    TEST_LOGGER("\n");
+
+    /* Replay the stream against the peg bitmasks */
+    start_cycles = get_cycles();
+    start_instret = get_instret();
+
+    PROF_BEGIN(PROF_HANOI_VERIFY);
+    uint32_t bad = hanoi_verify(HANOI_PACK_DISKS, hanoi_stream,
+                                HANOI_PACK_FMT, moves, 3);
+    PROF_END(PROF_HANOI_VERIFY);
+
+    end_cycles = get_cycles();
+    end_instret = get_instret();
+    cycles_elapsed = end_cycles - start_cycles;
+    instret_elapsed = end_instret - start_instret;
+
+    RECORD("q2.hanoi.verify", !bad, (uint32_t) cycles_elapsed,
+           (uint32_t) instret_elapsed, bad);
+
+    if (!bad) {
+        TEST_LOGGER("  Legality check: PASSED");
+    } else {
+        TEST_LOGGER("  Legality check: FAILED at move ");
+        print_dec(bad);
+    }
+    TEST_LOGGER("  Cycles: ");
+    print_dec((unsigned long) cycles_elapsed);
+    TEST_LOGGER("  Instructions: ");
+    print_dec((unsigned long) instret_elapsed);
+    TEST_LOGGER("\n");
+
+    /* Four pegs: same stream formats, same verifier */
+    TEST_LOGGER("\n  Four-peg stream, disks: ");
+    print_dec(HANOI4_DISKS);
+    TEST_LOGGER("  Split: ");
+    print_dec(hanoi4_split(HANOI4_DISKS));
+    TEST_LOGGER("\n");
+
+    uint32_t moves4 = hanoi4_moves(HANOI4_DISKS);
+    hanoi4_stream = arena_alloc(
+        &heap, HANOI4_FMT == HANOI_FMT_8BIT4 ? moves4 : ((moves4 + 7) >> 3) << 2);
+    if (!hanoi4_stream) {
+        TEST_LOGGER("  Four-peg stream: heap too small\n");
+    } else {
+        start_cycles = get_cycles();
+        start_instret = get_instret();
+
+        PROF_BEGIN(PROF_HANOI4_PACK);
+        moves4 = hanoi4_pack_moves(HANOI4_DISKS, hanoi4_stream, HANOI4_FMT);
+        PROF_END(PROF_HANOI4_PACK);
+
+        end_cycles = get_cycles();
+        end_instret = get_instret();
+        cycles_elapsed = end_cycles - start_cycles;
+        instret_elapsed = end_instret - start_instret;
+
+        bad = hanoi_verify(HANOI4_DISKS, hanoi4_stream, HANOI4_FMT, moves4, 4);
+        RECORD("q2.hanoi4.pack", !bad, (uint32_t) cycles_elapsed,
+               (uint32_t) instret_elapsed, moves4);
+
+        TEST_LOGGER("  Moves: ");
+        print_dec(moves4);
+        TEST_LOGGER("  Cycles: ");
+        print_dec((unsigned long) cycles_elapsed);
+        TEST_LOGGER("  Instructions: ");
+        print_dec((unsigned long) instret_elapsed);
+        TEST_LOGGER("\n");
+
+        if (!bad) {
+            TEST_LOGGER("  Legality check: PASSED\n");
+        } else {
+            TEST_LOGGER("  Legality check: FAILED at move ");
+            print_dec(bad);
+            TEST_LOGGER("\n");
+        }
+    }
+
+    int random_ok = check_random_access();
+    RECORD("q2.hanoi.random_access", random_ok, 0, 0, random_ok);
+    if (random_ok) {
+        TEST_LOGGER("  hanoi_move_at/hanoi_state_at: PASSED\n");
+    } else {
+        TEST_LOGGER("  hanoi_move_at/hanoi_state_at: FAILED\n");
+    }
+#ifdef PROPTEST
+    run_q2_props();
+#endif
+    run_q2_strategies();
+
+#ifdef HANOI_DUMP_STREAM
+    dump_stream(hanoi_stream,
+                HANOI_PACK_FMT == HANOI_FMT_8BIT
+                    ? moves
+                    : HANOI_STREAM_BYTES(HANOI_PACK_DISKS, HANOI_PACK_FMT));
+#endif
+
+    arena_report(&heap);
 
     TEST_LOGGER("\n=== All Tests Completed ===\n");
 
@@ -0,0 +1,87 @@
+/* Host reference of the q2-hanoi solver, see hanoi.h */
+
+#include "hanoi.h"
+
+/* (from << 2 | to) -> pair code */
+static const uint8_t pair_codes[12] = {0, 0, 1, 0, 2, 0, 3, 0, 4, 5, 0, 0};
+
+/* ((n - disk) & 1) << 2 | (earlier moves of disk % 3) -> pair code */
+static const uint8_t move_codes[8] = {0, 3, 4, 0, 1, 5, 2, 0};
+
+/* Peg of disk d after the first k moves */
+static unsigned disk_peg(unsigned n, uint64_t k, unsigned d)
+{
+    unsigned peg = (((k >> d) + 1) >> 1) % 3;
+
+    if (((n - d) & 1) && peg)
+        peg = 3 - peg;
+    return peg;
+}
+
+void hanoi_pack_range(unsigned n, uint64_t k0, uint64_t count, void *buf,
+                      unsigned fmt)
+{
+    uint8_t pos[HANOI_HOST_MAX_DISKS + 1];
+    uint8_t *out8 = buf;
+    uint32_t *out32 = buf;
+    uint64_t end = k0 + count;
+    unsigned step0 = (n & 1) + 1;
+    uint32_t acc = 0;
+    unsigned shift = 0;
+
+    for (unsigned d = 0; d < n; d++)
+        pos[d] = disk_peg(n, k0 - 1, d);
+
+    for (uint64_t k = k0; k != end; k++) {
+        unsigned disk = __builtin_ctzll(k);
+        unsigned from = pos[disk], to;
+
+        if (disk == 0) {
+            to = from + step0;
+            if (to >= 3)
+                to -= 3;
+        } else {
+            to = 3 - from - pos[0];
+        }
+        pos[disk] = to;
+
+        unsigned code = pair_codes[from << 2 | to];
+        if (fmt == HANOI_FMT_8BIT) {
+            *out8++ = disk << 3 | code;
+        } else {
+            acc |= code << shift;
+            shift += 3;
+            if (shift == 3 * HANOI_CODES_PER_WORD) {
+                *out32++ = acc;
+                acc = 0;
+                shift = 0;
+            }
+        }
+    }
+    if (shift)
+        *out32 = acc;
+}
+
+uint64_t hanoi_pack_moves(unsigned n, void *buf, unsigned fmt)
+{
+    uint64_t moves = (1ULL << n) - 1;
+
+    hanoi_pack_range(n, 1, moves, buf, fmt);
+    return moves;
+}
+
+unsigned hanoi_move_at(unsigned n, uint64_t k)
+{
+    unsigned disk = __builtin_ctzll(k);
+    unsigned r = (k >> (disk + 1)) % 3;
+
+    return disk << 3 | move_codes[((n - disk) & 1) << 2 | r];
+}
+
+void hanoi_state_at(unsigned n, uint64_t k, uint64_t pegs[3])
+{
+    pegs[0] = pegs[1] = pegs[2] = 0;
+
+    for (unsigned d = 0; d < n; d++)
+        pegs[disk_peg(n, k, d)] |= 1ULL << d;
+}
@@ -0,0 +1,32 @@
+#ifndef HANOI_H
+#define HANOI_H
+
+/* Host reference of the q2-hanoi solver (three pegs, A -> C).
+ * Same conventions and stream formats as ../hanoi_stream.h; move
+ * indices are 64-bit so games of up to 63 disks can be addressed.
+ */
+#include <stdint.h>
+
+#include "hanoi_stream.h"
+
+#define HANOI_HOST_MAX_DISKS 63
+
+/* Record of move k (1-based): (disk << 3) | pair code */
+#define HANOI_REC_DISK(rec) ((rec) >> 3)
+#define HANOI_REC_CODE(rec) ((rec) & 7)
+
+/* Sequential generator, same loop as hanoi_pack_moves in ../hanoi.S */
+uint64_t hanoi_pack_moves(unsigned n, void *buf, unsigned fmt);
+
+/* Moves k0 .. k0 + count - 1 only, seeded from the closed-form state
+ * at k0 - 1. With HANOI_FMT_3BIT, k0 - 1 must be a multiple of
+ * HANOI_CODES_PER_WORD so the range starts on a word boundary.
+ */
+void hanoi_pack_range(unsigned n, uint64_t k0, uint64_t count, void *buf,
+                      unsigned fmt);
+
+/* Closed forms: move k (1 <= k < 2^n) and peg bitmasks after k moves */
+unsigned hanoi_move_at(unsigned n, uint64_t k);
+void hanoi_state_at(unsigned n, uint64_t k, uint64_t pegs[3]);
+
+#endif /* HANOI_H */
@@ -0,0 +1,58 @@
+/* Host build of the four-peg solver (../hanoi4.c).
+ *
+ * Usage: hanoi4_gen <disks> [4|9] [stream.bin]
+ *
+ * Prints the Frame-Stewart split table up to 'disks' and, if a file is
+ * given, writes the move stream (format 4 by default) for hanoi_decode
+ * and hanoi_verify.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hanoi4.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "usage: %s <disks> [4|9] [stream.bin]\n", argv[0]);
+        return 2;
+    }
+
+    unsigned n = (unsigned) strtoul(argv[1], NULL, 0);
+    unsigned fmt = argc > 2 ? (unsigned) strtoul(argv[2], NULL, 0)
+                            : HANOI_FMT_4BIT;
+    if (n < 1 || n > HANOI4_MAX_DISKS ||
+        (fmt != HANOI_FMT_4BIT && fmt != HANOI_FMT_8BIT4) ||
+        (fmt == HANOI_FMT_8BIT4 && n > HANOI4_MAX_DISKS_8BIT)) {
+        fprintf(stderr, "hanoi4_gen: need 1 <= disks <= %d (16 for format 9)"
+                        " and format 4 or 9\n",
+                HANOI4_MAX_DISKS);
+        return 2;
+    }
+
+    printf(" n  split      moves\n");
+    for (unsigned i = 1; i <= n; i++)
+        printf("%2u  %5u  %9u\n", i, hanoi4_split(i), hanoi4_moves(i));
+
+    if (argc < 4)
+        return 0;
+
+    uint32_t moves = hanoi4_moves(n);
+    size_t bytes = fmt == HANOI_FMT_8BIT4
+                       ? moves
+                       : (moves + HANOI4_CODES_PER_WORD - 1) /
+                             HANOI4_CODES_PER_WORD * 4;
+    void *buf = malloc(bytes);
+    FILE *out = fopen(argv[3], "wb");
+    if (!buf || !out) {
+        perror(argv[3]);
+        return 1;
+    }
+    hanoi4_pack_moves(n, buf, fmt);
+    if (fwrite(buf, 1, bytes, out) != bytes || fclose(out)) {
+        perror(argv[3]);
+        return 1;
+    }
+    free(buf);
+    return 0;
+}
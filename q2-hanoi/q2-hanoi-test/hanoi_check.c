@@ -0,0 +1,118 @@
+/* Cross-check hanoi_move_at/hanoi_state_at against the sequential
+ * generator.
+ *
+ * Usage: hanoi_check [max_disks] [samples]
+ *
+ * Every move of every game up to max_disks (default 20) is compared,
+ * then 'samples' (default 1000000) random indices of a 63-disk game
+ * are checked for consistency between move k and the states at k - 1
+ * and k.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hanoi.h"
+
+static int check_full(unsigned n)
+{
+    uint64_t moves = (1ULL << n) - 1;
+    uint8_t *seq = malloc(moves ? moves : 1);
+    uint64_t expect[3] = {moves, 0, 0};
+    uint64_t pegs[3];
+
+    if (!seq) {
+        perror("malloc");
+        exit(1);
+    }
+    hanoi_pack_moves(n, seq, HANOI_FMT_8BIT);
+
+    for (uint64_t k = 1; k <= moves; k++) {
+        unsigned rec = seq[k - 1];
+        uint64_t bit = 1ULL << HANOI_REC_DISK(rec);
+
+        if (hanoi_move_at(n, k) != rec) {
+            fprintf(stderr, "n=%u k=%llu: move_at %#x, sequential %#x\n", n,
+                    (unsigned long long) k, hanoi_move_at(n, k), rec);
+            free(seq);
+            return 0;
+        }
+        expect[HANOI_CODE_FROM(HANOI_REC_CODE(rec))] &= ~bit;
+        expect[HANOI_CODE_TO(HANOI_REC_CODE(rec))] |= bit;
+        hanoi_state_at(n, k, pegs);
+        if (pegs[0] != expect[0] || pegs[1] != expect[1] ||
+            pegs[2] != expect[2]) {
+            fprintf(stderr, "n=%u k=%llu: state_at mismatch\n", n,
+                    (unsigned long long) k);
+            free(seq);
+            return 0;
+        }
+    }
+    free(seq);
+    return 1;
+}
+
+static uint64_t xorshift64(uint64_t *s)
+{
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+static int check_sampled(unsigned n, unsigned long samples)
+{
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    uint64_t mask = (1ULL << n) - 1;
+
+    for (unsigned long i = 0; i < samples; i++) {
+        uint64_t k = xorshift64(&seed) & mask;
+        uint64_t before[3], after[3];
+
+        if (k == 0)
+            continue;
+
+        unsigned rec = hanoi_move_at(n, k);
+        unsigned from = HANOI_CODE_FROM(HANOI_REC_CODE(rec));
+        unsigned to = HANOI_CODE_TO(HANOI_REC_CODE(rec));
+        uint64_t bit = 1ULL << HANOI_REC_DISK(rec);
+
+        hanoi_state_at(n, k - 1, before);
+        hanoi_state_at(n, k, after);
+
+        /* The moved disk is the top of 'from' and fits on 'to' */
+        if ((before[from] & -before[from]) != bit ||
+            (before[to] && (before[to] & -before[to]) < bit) ||
+            after[from] != (before[from] & ~bit) ||
+            after[to] != (before[to] | bit) ||
+            after[3 - from - to] != before[3 - from - to]) {
+            fprintf(stderr, "n=%u k=%llu: inconsistent move/state\n", n,
+                    (unsigned long long) k);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned max_disks = argc > 1 ? strtoul(argv[1], NULL, 0) : 20;
+    unsigned long samples = argc > 2 ? strtoul(argv[2], NULL, 0) : 1000000;
+
+    if (max_disks > HANOI_MAX_DISKS) {
+        fprintf(stderr, "hanoi_check: max_disks <= %d\n", HANOI_MAX_DISKS);
+        return 2;
+    }
+
+    for (unsigned n = 1; n <= max_disks; n++) {
+        if (!check_full(n))
+            return 1;
+    }
+    printf("full check, 1..%u disks: PASSED\n", max_disks);
+
+    if (!check_sampled(HANOI_HOST_MAX_DISKS, samples))
+        return 1;
+    printf("sampled check, %d disks, %lu indices: PASSED\n",
+           HANOI_HOST_MAX_DISKS, samples);
+    return 0;
+}
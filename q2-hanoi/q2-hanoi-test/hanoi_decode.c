@@ -0,0 +1,186 @@
+/* Expand a packed Hanoi move stream (see ../hanoi_stream.h) back into the
+ * "Move Disk N from X to Y" text printed by run_q2_game_hanoi.
+ *
+ * Usage: hanoi_decode [-p 3|4] <disks> <3|4|8|9> [stream.bin]
+ *
+ *   -p  peg count (default 3; formats 4 and 9 imply 4)
+ *   Reads stdin if no file is given.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hanoi4.h"
+#include "hanoi_stream.h"
+
+static const char peg_names[] = "ABCD";
+
+/* pair code -> from, to */
+static const uint8_t code_from3[6] = {0, 0, 1, 1, 2, 2};
+static const uint8_t code_to3[6] = {1, 2, 0, 2, 0, 1};
+static const uint8_t code_from4[12] = {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3};
+static const uint8_t code_to4[12] = {1, 2, 3, 0, 2, 3, 0, 1, 3, 0, 1, 2};
+
+static char out_buf[1 << 16];
+static size_t out_len;
+
+static void out_flush(void)
+{
+    fwrite(out_buf, 1, out_len, stdout);
+    out_len = 0;
+}
+
+static void emit_move(unsigned disk, unsigned from, unsigned to)
+{
+    char *p;
+    char digits[4];
+    int nd = 0;
+
+    if (out_len > sizeof(out_buf) - 64)
+        out_flush();
+    p = out_buf + out_len;
+
+    memcpy(p, "Move Disk ", 10);
+    p += 10;
+    disk += 1;
+    do {
+        digits[nd++] = '0' + disk % 10;
+        disk /= 10;
+    } while (disk);
+    while (nd)
+        *p++ = digits[--nd];
+    memcpy(p, " from ", 6);
+    p += 6;
+    *p++ = peg_names[from];
+    memcpy(p, " to ", 4);
+    p += 4;
+    *p++ = peg_names[to];
+    *p++ = '\n';
+
+    out_len = p - out_buf;
+}
+
+struct decoder {
+    uint64_t k, total;
+    unsigned npegs, code_bits, codes;
+    const uint8_t *code_from, *code_to;
+    uint64_t pegs[4]; /* only needed to name the disk of 4-bit codes */
+};
+
+/* 'disk' is the recorded disk, or -1 when the format does not store it */
+static int decode_move(struct decoder *d, unsigned code, int disk)
+{
+    if (code >= d->codes) {
+        fprintf(stderr, "hanoi_decode: move %llu: invalid pair code %u\n",
+                (unsigned long long) d->k, code);
+        return 0;
+    }
+
+    unsigned from = d->code_from[code], to = d->code_to[code];
+    if (disk < 0) {
+        if (d->npegs == 3) {
+            disk = __builtin_ctzll(d->k);
+        } else if (d->pegs[from]) {
+            disk = __builtin_ctzll(d->pegs[from]);
+            d->pegs[from] ^= 1ULL << disk;
+            d->pegs[to] |= 1ULL << disk;
+        } else {
+            fprintf(stderr, "hanoi_decode: move %llu: peg %c is empty\n",
+                    (unsigned long long) d->k, peg_names[from]);
+            return 0;
+        }
+    }
+    emit_move(disk, from, to);
+    d->k++;
+    return 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-p 3|4] <disks> <3|4|8|9> [stream.bin]\n",
+            prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned npegs = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:")) != -1) {
+        if (opt != 'p')
+            usage(argv[0]);
+        npegs = (unsigned) strtoul(optarg, NULL, 0);
+    }
+    if (argc - optind < 2 || argc - optind > 3)
+        usage(argv[0]);
+
+    const char *path = argv[optind + 2];
+    unsigned n = (unsigned) strtoul(argv[optind], NULL, 0);
+    unsigned fmt = (unsigned) strtoul(argv[optind + 1], NULL, 0);
+    if (fmt == HANOI_FMT_4BIT || fmt == HANOI_FMT_8BIT4)
+        npegs = 4;
+    if ((npegs != 3 && npegs != 4) || n > HANOI_MAX_DISKS ||
+        ((fmt == HANOI_FMT_3BIT || fmt == HANOI_FMT_8BIT) && npegs != 3) ||
+        (fmt == HANOI_FMT_8BIT4 && n > HANOI4_MAX_DISKS_8BIT) ||
+        (fmt != HANOI_FMT_3BIT && fmt != HANOI_FMT_4BIT &&
+         !HANOI_FMT_BYTES(fmt))) {
+        fprintf(stderr,
+                "hanoi_decode: need disks <= %d (16 for format 9) and "
+                "format 3 or 8 (3 pegs), 4 or 9 (4 pegs)\n",
+                HANOI_MAX_DISKS);
+        return 2;
+    }
+
+    FILE *in = stdin;
+    if (path && !(in = fopen(path, "rb"))) {
+        perror(path);
+        return 1;
+    }
+
+    struct decoder d = {
+        .k = 1,
+        .total = npegs == 4 ? hanoi4_moves(n) : (1ULL << n) - 1,
+        .npegs = npegs,
+        .code_bits = HANOI_CODE_BITS(npegs),
+        .codes = npegs == 4 ? 12 : 6,
+        .code_from = npegs == 4 ? code_from4 : code_from3,
+        .code_to = npegs == 4 ? code_to4 : code_to3,
+        .pegs = {(1ULL << n) - 1, 0, 0, 0},
+    };
+    unsigned mask = (1u << d.code_bits) - 1;
+    unsigned per_word = 32 / d.code_bits;
+    uint8_t buf[1 << 16];
+    size_t got;
+
+    while (d.k <= d.total && (got = fread(buf, 1, sizeof(buf), in)) > 0) {
+        if (HANOI_FMT_BYTES(fmt)) {
+            for (size_t i = 0; i < got && d.k <= d.total; i++) {
+                if (!decode_move(&d, buf[i] & mask, buf[i] >> d.code_bits))
+                    return 1;
+            }
+            continue;
+        }
+
+        /* Code-only formats: whole little-endian words */
+        for (size_t i = 0; i + 4 <= got && d.k <= d.total; i += 4) {
+            uint32_t w = buf[i] | buf[i + 1] << 8 | buf[i + 2] << 16 |
+                         (uint32_t) buf[i + 3] << 24;
+            for (unsigned j = 0; j < per_word && d.k <= d.total;
+                 j++, w >>= d.code_bits) {
+                if (!decode_move(&d, w & mask, -1))
+                    return 1;
+            }
+        }
+    }
+    out_flush();
+
+    if (d.k <= d.total) {
+        fprintf(stderr, "hanoi_decode: stream ended after %llu of %llu moves\n",
+                (unsigned long long) (d.k - 1), (unsigned long long) d.total);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+/* Legality check of a Hanoi move sequence.
+ *
+ * Replays moves from the start position (all disks on A) against 64-bit
+ * peg bitmasks: the source peg must not be empty, the moved disk must be
+ * its top disk, nothing smaller may sit on the destination, and all
+ * disks must end on the last peg (C, or D with four pegs). Input is read
+ * in large blocks so multi-GB streams from hanoi_shard are checked at a
+ * few operations per move.
+ *
+ * Usage: hanoi_verify [-p 3|4] <disks> <3|4|8|9|t> [file]   (stdin if no file)
+ *
+ *   -p    peg count (default 3; formats 4 and 9 imply 4)
+ *   3, 4  packed code-only stream (see ../hanoi_stream.h)
+ *   8, 9  packed 8-bit records, three-peg and four-peg layout
+ *   t     text, "Move Disk N from X to Y" lines as printed by the
+ *         bare-metal image; other lines are ignored and NUL bytes are
+ *         dropped (older images wrote one after "Move Disk "), e.g.
+ *         rv32emu test.elf | hanoi_verify 3 t
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hanoi.h"
+#include "hanoi4.h"
+
+#define FMT_TEXT 't'
+#define BLOCK_BYTES (1 << 20)
+
+struct verifier {
+    uint64_t pegs[4];
+    uint64_t k; /* moves replayed so far */
+    unsigned npegs, code_bits, codes;
+    const uint8_t *code_from, *code_to;
+};
+
+/* pair code -> from, to */
+static const uint8_t code_from3[6] = {0, 0, 1, 1, 2, 2};
+static const uint8_t code_to3[6] = {1, 2, 0, 2, 0, 1};
+static const uint8_t code_from4[12] = {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3};
+static const uint8_t code_to4[12] = {1, 2, 3, 0, 2, 3, 0, 1, 3, 0, 1, 2};
+
+/* 'bit' is the recorded disk, or 0 when the format does not store it */
+static int replay(struct verifier *v, unsigned code, uint64_t bit)
+{
+    v->k++;
+    if (code >= v->codes) {
+        fprintf(stderr, "move %llu: invalid pair code %u\n",
+                (unsigned long long) v->k, code);
+        return 0;
+    }
+
+    uint64_t *from = &v->pegs[v->code_from[code]];
+    uint64_t *to = &v->pegs[v->code_to[code]];
+    uint64_t top = *from & -*from;
+
+    if (!top) {
+        fprintf(stderr, "move %llu: peg %c is empty\n",
+                (unsigned long long) v->k, 'A' + v->code_from[code]);
+        return 0;
+    }
+    if (bit && bit != top) {
+        fprintf(stderr, "move %llu: disk %d is not on top of peg %c\n",
+                (unsigned long long) v->k, __builtin_ctzll(bit) + 1,
+                'A' + v->code_from[code]);
+        return 0;
+    }
+    if (*to & (top - 1)) {
+        fprintf(stderr, "move %llu: disk %d placed on a smaller disk\n",
+                (unsigned long long) v->k, __builtin_ctzll(top) + 1);
+        return 0;
+    }
+    *from ^= top;
+    *to |= top;
+    return 1;
+}
+
+static int tower_moved(const struct verifier *v)
+{
+    for (unsigned p = 0; p < v->npegs - 1; p++) {
+        if (v->pegs[p])
+            return 0;
+    }
+    return 1;
+}
+
+static int verify_packed(struct verifier *v, FILE *in, unsigned fmt)
+{
+    static uint8_t buf[BLOCK_BYTES];
+    unsigned mask = (1u << v->code_bits) - 1;
+    unsigned per_word = 32 / v->code_bits;
+    size_t got;
+
+    while ((got = fread(buf, 1, sizeof(buf), in)) > 0) {
+        if (HANOI_FMT_BYTES(fmt)) {
+            for (size_t i = 0; i < got; i++) {
+                if (!replay(v, buf[i] & mask, 1ULL << (buf[i] >> v->code_bits)))
+                    return 0;
+            }
+            continue;
+        }
+
+        if (got & 3) {
+            fprintf(stderr, "packed stream is not a whole number of words\n");
+            return 0;
+        }
+        for (size_t i = 0; i < got; i += 4) {
+            uint32_t w = buf[i] | buf[i + 1] << 8 | buf[i + 2] << 16 |
+                         (uint32_t) buf[i + 3] << 24;
+            /* The last word may be partial: its tail is zero padding,
+             * which would decode as A->B moves, so stop there once the
+             * tower has been moved.
+             */
+            for (unsigned j = 0; j < per_word; j++, w >>= v->code_bits) {
+                if (!w && tower_moved(v))
+                    break;
+                if (!replay(v, w & mask, 0))
+                    return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* fgets without the NULs: sscanf would stop at the first one. Lines
+ * longer than the buffer are cut; returns 0 at end of input.
+ */
+static int read_line(FILE *in, char *line, size_t size)
+{
+    size_t len = 0;
+    int c;
+
+    while ((c = getc(in)) != EOF) {
+        if (c == '\0')
+            continue;
+        if (len < size - 2 || c == '\n')
+            line[len++] = (char) c;
+        if (c == '\n')
+            break;
+    }
+    line[len] = '\0';
+    return len > 0 || c != EOF;
+}
+
+static int verify_text(struct verifier *v, FILE *in)
+{
+    char line[128];
+    unsigned disk;
+    char from, to;
+    char last = 'A' + v->npegs - 1;
+
+    while (read_line(in, line, sizeof(line))) {
+        if (sscanf(line, "Move Disk %u from %c to %c", &disk, &from, &to) != 3)
+            continue;
+        if (disk < 1 || disk > HANOI_HOST_MAX_DISKS || from < 'A' ||
+            from > last || to < 'A' || to > last || from == to) {
+            fprintf(stderr, "move %llu: malformed line: %s",
+                    (unsigned long long) v->k + 1, line);
+            return 0;
+        }
+        unsigned code = v->npegs == 4 ? HANOI4_PAIR_CODE(from - 'A', to - 'A')
+                                      : HANOI_PAIR_CODE(from - 'A', to - 'A');
+        if (!replay(v, code, 1ULL << (disk - 1)))
+            return 0;
+    }
+    return 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-p 3|4] <disks> <3|4|8|9|t> [file]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned npegs = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:")) != -1) {
+        if (opt != 'p')
+            usage(argv[0]);
+        npegs = (unsigned) strtoul(optarg, NULL, 0);
+    }
+    if (argc - optind < 2 || argc - optind > 3)
+        usage(argv[0]);
+
+    const char *path = argv[optind + 2];
+    unsigned n = (unsigned) strtoul(argv[optind], NULL, 0);
+    unsigned fmt = argv[optind + 1][0] == FMT_TEXT
+                       ? FMT_TEXT
+                       : (unsigned) strtoul(argv[optind + 1], NULL, 0);
+    if (fmt == HANOI_FMT_4BIT || fmt == HANOI_FMT_8BIT4)
+        npegs = 4;
+    if ((fmt == HANOI_FMT_3BIT || fmt == HANOI_FMT_8BIT) && npegs != 3)
+        usage(argv[0]);
+
+    /* 8-bit records leave 5 (format 8) or 4 (format 9) bits for the disk */
+    unsigned max_disks = fmt == HANOI_FMT_8BIT    ? HANOI_MAX_DISKS
+                         : fmt == HANOI_FMT_8BIT4 ? HANOI4_MAX_DISKS_8BIT
+                                                  : HANOI_HOST_MAX_DISKS;
+    if (n < 1 || n > max_disks || (npegs != 3 && npegs != 4) ||
+        (fmt != HANOI_FMT_3BIT && fmt != HANOI_FMT_4BIT &&
+         !HANOI_FMT_BYTES(fmt) && fmt != FMT_TEXT)) {
+        fprintf(stderr,
+                "hanoi_verify: need 1 <= disks <= %u, pegs 3 or 4 and "
+                "format 3, 4, 8, 9 or t\n",
+                max_disks);
+        return 2;
+    }
+
+    FILE *in = stdin;
+    if (path && !(in = fopen(path, "rb"))) {
+        perror(path);
+        return 1;
+    }
+
+    uint64_t all = (1ULL << n) - 1;
+    struct verifier v = {
+        .pegs = {all, 0, 0, 0},
+        .npegs = npegs,
+        .code_bits = HANOI_CODE_BITS(npegs),
+        .codes = npegs == 4 ? 12 : 6,
+        .code_from = npegs == 4 ? code_from4 : code_from3,
+        .code_to = npegs == 4 ? code_to4 : code_to3,
+    };
+    int ok = fmt == FMT_TEXT ? verify_text(&v, in) : verify_packed(&v, in, fmt);
+
+    if (ok && v.pegs[npegs - 1] != all) {
+        fprintf(stderr, "after %llu moves the tower is not on peg %c\n",
+                (unsigned long long) v.k, 'A' + npegs - 1);
+        ok = 0;
+    }
+    uint64_t optimal = npegs == 3 ? all
+                       : n <= HANOI4_MAX_DISKS ? hanoi4_moves(n)
+                                               : 0;
+    printf("%s: %llu moves, %s\n", path ? path : "stdin",
+           (unsigned long long) v.k,
+           !ok                ? "ILLEGAL"
+           : v.k == optimal ? "legal, optimal"
+                              : "legal");
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "arena.h"
+#include "bench.h"
+#include "prof.h"
+#include "prop.h"
+#include "record.h"
+
 #define printstr(ptr, length)                   \
     do {                                        \
         asm volatile(                           \
@@ -19,7 +25,7 @@
 
 #define TEST_LOGGER(msg)                     \
     {                                        \
-        char _msg[] = msg;                   \
+        static const char _msg[] = msg;      \
         TEST_OUTPUT(_msg, sizeof(_msg) - 1); \
     }
 
@@ -299,43 +305,32 @@ static uint64_t udiv64_32(uint64_t dividend, uint32_t divisor_u32)
     return quotient;
 }
 
-/* Lookup table: initial estimates for 65536 / sqrt(2^n)
- * Provides starting approximations indexed by MSB position
- * Usage:
- * For input x, find MSB position exp = 31 - clz(x)
- * Initial estimate: y = rsqrt_table[exp]
- * Examples:
- * x = 1 (2^0)  -> exp = 0  -> y = 65536 (exact: 65536/sqrt(1))
+/* Lookup table: initial estimates for 65536 / sqrt(x)
+ * Generated at build time by host/gen_tables (make RSQRT_LUT_SHIFT=n),
+ * with 2^n entries per power of two, each checked against an exact
+ * reference. Index: MSB position exp = 31 - clz(x), followed by the
+ * next n bits of x. Examples (n = 0):
+ * x = 1 (2^0)  -> exp = 0  -> y = 65535 (exact: 65536, clamped to 16 bits)
  * x = 16 (2^4) -> exp = 4  -> y = 16384 (exact: 65536/sqrt(16))
  * x = 1024     -> exp = 10 -> y = 2048 (exact: 65536/sqrt(1024))
- *
- * Each entry computed as: round(65536 / sqrt(2^n))
  */
-static const uint16_t rsqrt_table[32] = {
-        65535, 46341, 32768, 23170, 16384,  /* 2^0 to 2^4 */
-        11585, 8192,  5793,  4096,  2896,   /* 2^5 to 2^9 */
-        2048,  1448,  1024,  724,   512,    /* 2^10 to 2^14 */
-        362,   256,   181,   128,   90,     /* 2^15 to 2^19 */
-        64,    45,    32,    23,    16,     /* 2^20 to 2^24 */
-        11,    8,     6,     4,     3,      /* 2^25 to 2^ 29 */
-        2,     1                            /* 2^3O, 2^3l */
-} ;
+#include "rsqrt_table.h"
 
 /* Fast reciprocal square root: 65536 / sqrt(x)
-* Computes approximation of 1/sqrt(x) scaled by 2"16.
-* I nput : x - any uint32_t value
-* Output: y:::: 65536 / sqrt(x), with 3-8% relative error
-*
-* Edge Cases:
-* X = 0 ➔ 0xFFFFFFFF (represents infinity)
-* X = 1 ➔ 65536 (exact)
-* X = 2^n ➔ accurate (0-2% error)
-* X = MAX_U32 ➔ 1 (minimum non-zero result)
-* Algorithm Overview:
-* 1. LUT lookup: ~20% error
-* 2 . + Interpolation: ~10% error
-* 3 . + 2 Newton: ~3 - 8% error
-*/
+ * Computes approximation of 1/sqrt(x) scaled by 2^16.
+ * Input:  x - any uint32_t value
+ * Output: y ~= 65536 / sqrt(x), with 3-8% relative error
+ *
+ * Edge Cases:
+ * x = 0 -> 0xFFFFFFFF (represents infinity)
+ * x = 1 -> 65536 (exact)
+ * x = 2^n -> accurate (0-2% error)
+ * x = MAX_U32 -> 1 (minimum non-zero result)
+ * Algorithm Overview:
+ * 1. LUT lookup: ~20% error (one entry per power of two)
+ * 2. + Interpolation: ~10% error
+ * 3. + 2 Newton: ~3-8% error
+ */
 uint32_t fast_rsqrt(uint32_t x)
 {
     if (x == 0) return 0xFFFFFFFF; // Handle zero case
@@ -343,13 +338,16 @@ uint32_t fast_rsqrt(uint32_t x)
 
     // Step 1: Find MSB position
     int exp = 31 - clz(x); // Count leading zeros
-    uint32_t y = rsqrt_table[exp]; // Initial estimate
+    // Position of x inside [2^exp, 2^(exp+1)) in Q0.16
+    uint32_t pos = (uint32_t) ((((uint64_t)x - (1UL << exp)) << 16) >> exp);
+    uint32_t idx = ((uint32_t) exp << RSQRT_TABLE_SHIFT) | (pos >> (16 - RSQRT_TABLE_SHIFT));
+    uint32_t y = rsqrt_table[idx]; // Initial estimate
 
     if (x > (1u << exp)) {
     // Step 2: Linear interpolation for non-power-of-2 inputs
-        uint32_t y_next = (exp < 31) ? rsqrt_table[exp + 1] : 0; // Next estimate
+        uint32_t y_next = (idx + 1 < RSQRT_TABLE_SIZE) ? rsqrt_table[idx + 1] : 0; // Next estimate
         uint32_t delta = y - y_next; // Difference between estimates
-        uint32_t frac =(uint32_t) ((((uint64_t)x - (1UL << exp)) << 16) >> exp);
+        uint32_t frac = (pos << RSQRT_TABLE_SHIFT) & 0xFFFF; // Position between the two entries
         y -= (uint32_t) ((delta * frac) >> 16); // Interpolate
     // Step 3: Newton-Raphson iterations
         for (int iter = 0; iter < 2; iter++) {
@@ -379,35 +377,41 @@ uint32_t fast_rsqrt(uint32_t x)
 
 /* --- Automated Test Helper Functions (Start) --- */
 
+/* Profiling scope ids (common/prof.h) */
+enum {
+    PROF_Q3_SUITE,
+    PROF_RSQRT,
+};
+
+/* fast_rsqrt inside a profiling scope */
+static uint32_t fast_rsqrt_prof(uint32_t x)
+{
+    PROF_BEGIN(PROF_RSQRT);
+    uint32_t y = fast_rsqrt(x);
+    PROF_END(PROF_RSQRT);
+    return y;
+}
+
 /**
  * @brief Check if two values are exactly equal
  * @param test_name Name of the test case
+ * @param name_len  Length of test_name, from the vector table
+ * @param record_id Result record id, "q3.rsqrt.<input>"
  * @param actual    Actual value computed by the function
  * @param expected  Expected exact value
  * @param cycles    Cycles taken to compute 'actual'
  * @param all_passed Pointer to the overall pass status (set to 0 if failed)
  */
-static void check_exact(const char* test_name, uint32_t actual, uint32_t expected, uint64_t cycles, int* all_passed) {
+static void check_exact(const char* test_name, uint32_t name_len, const char* record_id, uint32_t actual, uint32_t expected, uint64_t cycles, int* all_passed) {
+    RECORD(record_id, actual == expected, (uint32_t) cycles, 0, actual);
+
     if (actual == expected) {
         TEST_LOGGER("    [PASS] ");
     } else {
         TEST_LOGGER("    [FAIL] ");
     }
     
-    /* --- New Code (Fixing .rodata reading issue) --- */
-    char name_buf[64]; // Create a 64-byte buffer on the stack
-    const char* s = test_name;
-    size_t len = 0;
-    // Manually copy string from .rodata (test_name) to stack (name_buf)
-    // Assume test_name does not exceed 63 characters
-    while (*s != '\0' && len < 63) {
-        name_buf[len] = *s;
-        s++;
-        len++;
-    }
-    // Now 'name_buf' is on the stack, 'len' is its length
-    TEST_OUTPUT(name_buf, len);
-    /* --- Copy End --- */
+    TEST_OUTPUT(test_name, name_len); // read in place from .rodata
 
     if (actual == expected) {
         TEST_LOGGER(" | Cycles: ");
@@ -428,13 +432,15 @@ static void check_exact(const char* test_name, uint32_t actual, uint32_t expecte
 /**
  * @brief Check if a value is within a specific percentage error margin of the expected value
  * @param test_name Name of the test case
+ * @param name_len  Length of test_name, from the vector table
+ * @param record_id Result record id, "q3.rsqrt.<input>"
  * @param actual    Actual value computed by the function
  * @param expected  Reference expected value
  * @param margin_percent Allowed error percentage (e.g., 10 means 10%)
  * @param cycles    Cycles taken to compute 'actual'
  * @param all_passed Pointer to the overall pass status (set to 0 if failed)
  */
-static void check_approx(const char* test_name, uint32_t actual, uint32_t expected, uint32_t margin_percent, uint64_t cycles, int* all_passed) {
+static void check_approx(const char* test_name, uint32_t name_len, const char* record_id, uint32_t actual, uint32_t expected, uint32_t margin_percent, uint64_t cycles, int* all_passed) {
     /* --- 1. Calculate diff and margin --- */
     // Calculate absolute difference
     uint32_t diff = (actual > expected) ? (actual - expected) : (expected - actual);
@@ -450,20 +456,13 @@ static void check_approx(const char* test_name, uint32_t actual, uint32_t expect
     /* --- Calculation End --- */
 
 
+    RECORD(record_id, (uint64_t)diff <= margin, (uint32_t) cycles, 0, actual);
+
     /* --- 2. Check and Print Results --- */
     if ((uint64_t)diff <= margin) {
         TEST_LOGGER("    [PASS] ");
         
-        /* --- Copy test_name to stack (Fixing .rodata reading issue) --- */
-        char name_buf[64];
-        const char* s = test_name;
-        size_t len = 0;
-        while (*s != '\0' && len < 63) {
-            name_buf[len] = *s;
-            s++;
-            len++;
-        }
-        TEST_OUTPUT(name_buf, len); // Print from stack
+        TEST_OUTPUT(test_name, name_len);
         
         TEST_LOGGER(" (Got: ");
         print_dec(actual);
@@ -473,16 +472,7 @@ static void check_approx(const char* test_name, uint32_t actual, uint32_t expect
     } else {
         TEST_LOGGER("    [FAIL] ");
         
-        /* --- Copy test_name to stack (Fixing .rodata reading issue) --- */
-        char name_buf[64];
-        const char* s = test_name;
-        size_t len = 0;
-        while (*s != '\0' && len < 63) {
-            name_buf[len] = *s;
-            s++;
-            len++;
-        }
-        TEST_OUTPUT(name_buf, len); // Print from stack
+        TEST_OUTPUT(test_name, name_len);
         
         TEST_LOGGER(": Expected ~");
         print_dec(expected);
@@ -500,89 +490,183 @@ static void check_approx(const char* test_name, uint32_t actual, uint32_t expect
 }
 
 
+/* Tolerance modes of a test vector */
+enum {
+    VEC_EXACT,  /* result must equal 'expected' */
+    VEC_APPROX, /* within margin_percent of 'expected' (at least 2) */
+};
+
+struct rsqrt_vector {
+    const char *group; /* heading printed before this vector, or NULL */
+    uint8_t group_len; /* strlen(group), 0 without a heading */
+    const char *name;
+    uint8_t name_len;      /* strlen(name), so printing walks no bytes */
+    const char *record_id; /* "q3.rsqrt.<input>", see common/record.h */
+    uint32_t input;
+    uint32_t expected;
+    uint8_t mode;
+    uint8_t margin_percent;
+    uint8_t announce;      /* print "  -> Calling <name>..." first */
+};
+
+/* name or heading and its length */
+#define VEC_NAME(s) s, sizeof(s) - 1
+#define VEC_GROUP(s) VEC_NAME(s)
+#define VEC_NO_GROUP NULL, 0
+
+// According to comments, error range is 3-8%. We use 10% as tolerance (margin_percent = 10).
+// Expected values are calculated based on (uint32_t)(65536.0 / sqrt(x)).
+static const struct rsqrt_vector rsqrt_vectors[] = {
+    // --- 1. Edge/Special Cases (Should be Exact) ---
+    {VEC_GROUP("  Testing edge cases...\n"), VEC_NAME("rsqrt(0)"), "q3.rsqrt.0", 0, 0xFFFFFFFF, VEC_EXACT, 0, 1},
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(1)"), "q3.rsqrt.1", 1, 65536, VEC_EXACT, 0, 1},
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(0xFFFFFFFF)"), "q3.rsqrt.0xffffffff", 0xFFFFFFFF, 1, VEC_EXACT, 0, 1},
+
+    // --- 2. Powers of 2 (From comments and table, should be exact) ---
+    {VEC_GROUP("  Testing powers of 2...\n"), VEC_NAME("rsqrt(4)"), "q3.rsqrt.4", 4, 32768, VEC_EXACT, 0, 0},
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(16)"), "q3.rsqrt.16", 16, 16384, VEC_EXACT, 0, 0},
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(1024)"), "q3.rsqrt.1024", 1024, 2048, VEC_EXACT, 0, 0},
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(65536)"), "q3.rsqrt.65536", 65536, 256, VEC_EXACT, 0, 0},       // 2^16
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(1048576)"), "q3.rsqrt.1048576", 1048576, 64, VEC_EXACT, 0, 0},  // 2^20
+
+    // --- 3. General Cases (Using 10% Tolerance) ---
+    {VEC_GROUP("  Testing general cases (10% tolerance)...\n"), VEC_NAME("rsqrt(100)"), "q3.rsqrt.100", 100, 6554,
+     VEC_APPROX, 10, 0},                                                                   // Exact: 6553.6
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(2)"), "q3.rsqrt.2", 2, 46341, VEC_APPROX, 10, 0},               // Exact: 46340.9
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(10)"), "q3.rsqrt.10", 10, 20723, VEC_APPROX, 10, 0},            // Exact: 20723.0
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(42)"), "q3.rsqrt.42", 42, 10103, VEC_APPROX, 10, 0},            // Exact: 10103.4
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(12345)"), "q3.rsqrt.12345", 12345, 590, VEC_APPROX, 10, 0},     // Exact: 589.6
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(1000000)"), "q3.rsqrt.1000000", 1000000, 66, VEC_APPROX, 10, 0},  // Exact: 65.53
+    {VEC_NO_GROUP, VEC_NAME("rsqrt(2000000000)"), "q3.rsqrt.2000000000", 2000000000, 1, VEC_APPROX, 10, 0},  // Exact: 1.46
+};
+
+#define RSQRT_VECTORS (sizeof(rsqrt_vectors) / sizeof(rsqrt_vectors[0]))
+
 /**
- * @brief Run the fast_rsqrt automated test suite
+ * @brief Run the fast_rsqrt automated test suite over rsqrt_vectors
  * @return 1 if all tests passed, 0 if any test failed
  */
 int run_q3_rsqrt() {
     int all_passed = 1; // Assume all passed until failure
-    uint64_t t_start, t_end, t_diff;
-    uint32_t result;
 
     TEST_LOGGER("  Running fast_rsqrt test suite...\n");
-    
-    // According to comments, error range is 3-8%. We use 10% as tolerance (margin_percent = 10).
-    // Expected values are calculated based on (uint32_t)(65536.0 / sqrt(x)).
 
-    // --- 1. Edge/Special Cases (Should be Exact) ---
-    TEST_LOGGER("  Testing edge cases...\n");
-    TEST_LOGGER("  -> Calling rsqrt(0)...\n");
-    t_start = get_cycles();
-    result = fast_rsqrt(0);
-    t_end = get_cycles();
-    check_exact("rsqrt(0)", result, 0xFFFFFFFF, t_end - t_start, &all_passed);
-    
-    TEST_LOGGER("  -> Calling rsqrt(1)...\n");
-    t_start = get_cycles();
-    result = fast_rsqrt(1);
-    t_end = get_cycles();
-    check_exact("rsqrt(1)", result, 65536, t_end - t_start, &all_passed);
-
-    TEST_LOGGER("  -> Calling rsqrt(0xFFFFFFFF)...\n");
-    t_start = get_cycles();
-    result = fast_rsqrt(0xFFFFFFFF);
-    t_end = get_cycles();
-    check_exact("rsqrt(0xFFFFFFFF)", result, 1, t_end - t_start, &all_passed);
+    for (uint32_t i = 0; i < RSQRT_VECTORS; i++) {
+        const struct rsqrt_vector *v = &rsqrt_vectors[i];
 
-    // --- 2. Powers of 2 (From comments and table, should be exact) ---
-    TEST_LOGGER("  Testing powers of 2...\n");
-    
-    t_start = get_cycles(); result = fast_rsqrt(4); t_end = get_cycles();
-    check_exact("rsqrt(4)", result, 32768, t_end - t_start, &all_passed);
-    
-    t_start = get_cycles(); result = fast_rsqrt(16); t_end = get_cycles();
-    check_exact("rsqrt(16)", result, 16384, t_end - t_start, &all_passed);
-    
-    t_start = get_cycles(); result = fast_rsqrt(1024); t_end = get_cycles();
-    check_exact("rsqrt(1024)", result, 2048, t_end - t_start, &all_passed);
-    
-    t_start = get_cycles(); result = fast_rsqrt(65536); t_end = get_cycles();
-    check_exact("rsqrt(65536)", result, 256, t_end - t_start, &all_passed); // 2^16
-    
-    t_start = get_cycles(); result = fast_rsqrt(1048576); t_end = get_cycles();
-    check_exact("rsqrt(1048576)", result, 64, t_end - t_start, &all_passed); // 2^20
+        if (v->group)
+            TEST_OUTPUT(v->group, v->group_len);
+        if (v->announce) {
+            TEST_LOGGER("  -> Calling ");
+            TEST_OUTPUT(v->name, v->name_len);
+            TEST_LOGGER("...\n");
+        }
 
-    // --- 3. General Cases (Using 10% Tolerance) ---
-    TEST_LOGGER("  Testing general cases (10% tolerance)...\n");
-    
-    // Case from comments: rsqrt(100)
-    t_start = get_cycles(); result = fast_rsqrt(100); t_end = get_cycles();
-    check_approx("rsqrt(100)", result, 6554, 10, t_end - t_start, &all_passed); // Exact: 6553.6
-    
-    // Other test cases
-    t_start = get_cycles(); result = fast_rsqrt(2); t_end = get_cycles();
-    check_approx("rsqrt(2)", result, 46341, 10, t_end - t_start, &all_passed);     // Exact: 46340.9
-    
-    t_start = get_cycles(); result = fast_rsqrt(10); t_end = get_cycles();
-    check_approx("rsqrt(10)", result, 20723, 10, t_end - t_start, &all_passed);   // Exact: 20723.0
-    
-    t_start = get_cycles(); result = fast_rsqrt(42); t_end = get_cycles();
-    check_approx("rsqrt(42)", result, 10103, 10, t_end - t_start, &all_passed);   // Exact: 10103.4
-    
-    t_start = get_cycles(); result = fast_rsqrt(12345); t_end = get_cycles();
-    check_approx("rsqrt(12345)", result, 590, 10, t_end - t_start, &all_passed); // Exact: 589.6
-    
-    t_start = get_cycles(); result = fast_rsqrt(1000000); t_end = get_cycles();
-    check_approx("rsqrt(1000000)", result, 66, 10, t_end - t_start, &all_passed); // Exact: 65.53
-    
-    t_start = get_cycles(); result = fast_rsqrt(2000000000); t_end = get_cycles();
-    check_approx("rsqrt(2000000000)", result, 1, 10, t_end - t_start, &all_passed); // Exact: 1.46
+        uint64_t t_start = get_cycles();
+        uint32_t result = fast_rsqrt_prof(v->input);
+        uint64_t t_end = get_cycles();
+
+        if (v->mode == VEC_EXACT)
+            check_exact(v->name, v->name_len, v->record_id, result, v->expected, t_end - t_start, &all_passed);
+        else
+            check_approx(v->name, v->name_len, v->record_id, result, v->expected, v->margin_percent, t_end - t_start, &all_passed);
+    }
 
     return all_passed;
 }
 
+/* Property batches come from the linker heap (common/arena.h) */
+static struct arena heap;
+
+#ifdef PROPTEST
+/* fast_rsqrt is non-increasing up to one unit: an exact power of two
+ * returns its table entry while 2^k - 1 goes through the truncating
+ * Newton steps, so rsqrt(2^16) = 256 follows rsqrt(2^16 - 1) = 255.
+ */
+static void run_q3_props(void)
+{
+    struct prop_hist hist;
+    uint32_t seed = PROP_SEED, failures = 0, first_bad = 0;
+    arena_mark_t mark = arena_mark(&heap);
+    uint32_t *xs = arena_alloc(&heap, PROP_ITERS * sizeof(uint32_t));
+    uint32_t *ys = arena_alloc(&heap, PROP_ITERS * sizeof(uint32_t));
+    uint32_t *rxs = arena_alloc(&heap, PROP_ITERS * sizeof(uint32_t));
+    uint32_t *rys = arena_alloc(&heap, PROP_ITERS * sizeof(uint32_t));
+
+    TEST_LOGGER("\n  Property tests:\n");
+    if (!xs || !ys || !rxs || !rys) {
+        TEST_LOGGER("  [prop] heap too small\n");
+        arena_report(&heap);
+        arena_reset(&heap, mark);
+        return;
+    }
+
+    /* Draw the whole batch, run it, then check it */
+    for (uint32_t i = 0; i < PROP_ITERS; i++) {
+        uint32_t x = prop_rand_mag(&seed), y = prop_rand_mag(&seed);
+        xs[i] = x < y ? x : y;
+        ys[i] = x < y ? y : x;
+    }
+
+    prop_hist_reset(&hist);
+    for (uint32_t i = 0; i < PROP_ITERS; i++) {
+        uint32_t c0 = prop_cycles();
+        rxs[i] = fast_rsqrt(xs[i]);
+        uint32_t c1 = prop_cycles();
+        rys[i] = fast_rsqrt(ys[i]);
+        prop_hist_add(&hist, c1 - c0);
+    }
+
+    for (uint32_t i = 0; i < PROP_ITERS; i++) {
+        if (xs[i] != 0 && rys[i] > rxs[i] + 1) {
+            if (!failures)
+                first_bad = xs[i];
+            failures++;
+        }
+    }
+
+    prop_result("rsqrt monotonic", "q3.prop.rsqrt_monotonic", PROP_ITERS,
+                failures, first_bad);
+    prop_hist_report("fast_rsqrt", &hist);
+    arena_reset(&heap, mark);
+}
+#endif
+
 /* --- Automated Test Helper Functions (End) --- */
 
+/* Benchmark inputs (common/bench.h); one-argument kernels ignore b */
+static struct bench_arg clz_bench_args[] = {
+    {1, 0}, {0x1234, 0}, {0x00ff0000, 0}, {0x80000000, 0},
+};
+
+static struct bench_arg mul32_bench_args[] = {
+    {3, 5}, {0xffff, 0xffff}, {0x12345678, 0x9abcdef0}, {0xffffffff, 0xffffffff},
+};
+
+static struct bench_arg rsqrt_bench_args[] = {
+    {2, 0}, {100, 0}, {12345, 0}, {1000000, 0}, {2000000000, 0},
+};
+
+/* Typed bench_fn trampolines; mul32 is called as uint64_t and its
+ * product narrowed afterwards
+ */
+BENCH_TRAMPOLINE(bench_clz, clz(a))
+BENCH_TRAMPOLINE(bench_mul32, mul32(a, b))
+BENCH_TRAMPOLINE(bench_fast_rsqrt, fast_rsqrt(a))
+
+static void run_q3_bench(void)
+{
+    TEST_LOGGER("\n  Benchmarks (net cycles per call):\n");
+    bench_run("clz", bench_clz, clz_bench_args, BENCH_NARGS(clz_bench_args), 1);
+    bench_run("clz", bench_clz, clz_bench_args, BENCH_NARGS(clz_bench_args), 8);
+    bench_run("mul32", bench_mul32, mul32_bench_args,
+              BENCH_NARGS(mul32_bench_args), 1);
+    bench_run("mul32", bench_mul32, mul32_bench_args,
+              BENCH_NARGS(mul32_bench_args), 8);
+    bench_run("fast_rsqrt", bench_fast_rsqrt, rsqrt_bench_args,
+              BENCH_NARGS(rsqrt_bench_args), 1);
+}
+
 
 int main(void)
 {
@@ -590,11 +674,18 @@ int main(void)
     uint64_t start_instret, end_instret, instret_elapsed;
 
     TEST_LOGGER("\n=== HW2 FastRsqrt Tests in Bare Metal ===\n\n");
+
+    arena_init_heap(&heap);
+
+    PROF_NAME(PROF_Q3_SUITE, "q3-rsqrt suite");
+    PROF_NAME(PROF_RSQRT, "fast_rsqrt");
     
     start_cycles = get_cycles();
     start_instret = get_instret();
 
+    PROF_BEGIN(PROF_Q3_SUITE);
     int passed = run_q3_rsqrt();
+    PROF_END(PROF_Q3_SUITE);
 
     end_cycles = get_cycles();
     end_instret = get_instret();
@@ -607,12 +698,22 @@ int main(void)
         TEST_LOGGER("\n  q3-rsqrt Test Suite: FAILED\n");
     }
 
+    RECORD("q3.rsqrt.suite", passed, (uint32_t) cycles_elapsed,
+           (uint32_t) instret_elapsed, passed);
+
     TEST_LOGGER("  Total Cycles: ");
     print_dec((unsigned long) cycles_elapsed);
     TEST_LOGGER("  Total Instructions: ");
     print_dec((unsigned long) instret_elapsed);
     TEST_LOGGER("\n");
 
+    arena_check(&heap, "q3.heap.check");
+    run_q3_bench();
+#ifdef PROPTEST
+    run_q3_props();
+#endif
+    arena_report(&heap);
+
     TEST_LOGGER("\n=== All Tests Completed ===\n");
 
     return 0;